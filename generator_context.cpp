@@ -0,0 +1,75 @@
+#include <random>
+#include "generator_context.h"
+
+uint64_t derive_stream_seed(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + (stream + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+GeneratorContext::GeneratorContext(RngEngine engine) : engine_(engine) {
+    std::random_device rd;
+    seed((uint64_t(rd()) << 32) | rd());
+}
+
+GeneratorContext::GeneratorContext(uint64_t seed_value, uint64_t stream, RngEngine engine) : engine_(engine) {
+    seed(seed_value, stream);
+}
+
+// Only the selected engine is (re)initialised, so reseeding xoshiro or Philox costs a few instructions
+
+void GeneratorContext::seed(uint64_t seed_value, uint64_t stream) {
+    seed_ = seed_value;
+    stream_ = stream;
+
+    switch (engine_) {
+        case RNG_XOSHIRO256SS: {
+            // Expand the 64-bit stream seed with splitmix64 as recommended in [6]
+            uint64_t z = derive_stream_seed(seed_value, stream);
+            for (int i = 0; i < 4; i++) {
+                xoshiro_[i] = z = derive_stream_seed(z, i);
+            }
+            break;
+        }
+        case RNG_PHILOX4X32:
+            philox_counter_ = 0;
+            philox_available_ = 0;
+            break;
+        case RNG_MT19937_64:
+        default:
+            mt_.seed(derive_stream_seed(seed_value, stream));
+            break;
+    }
+}
+
+// Philox4x32-10: ten rounds over the 128-bit block (block counter, stream) keyed by the seed
+
+void GeneratorContext::philox_refill() {
+    const uint32_t M0 = 0xD2511F53u;
+    const uint32_t M1 = 0xCD9E8D57u;
+    const uint32_t W0 = 0x9E3779B9u;
+    const uint32_t W1 = 0xBB67AE85u;
+
+    uint32_t c[4] = {uint32_t(philox_counter_), uint32_t(philox_counter_ >> 32),
+                     uint32_t(stream_), uint32_t(stream_ >> 32)};
+    uint32_t k[2] = {uint32_t(seed_), uint32_t(seed_ >> 32)};
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = uint64_t(M0) * c[0];
+        uint64_t p1 = uint64_t(M1) * c[2];
+        uint32_t next[4] = {uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1),
+                            uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0)};
+        c[0] = next[0];
+        c[1] = next[1];
+        c[2] = next[2];
+        c[3] = next[3];
+        k[0] += W0;
+        k[1] += W1;
+    }
+
+    philox_counter_++;
+    philox_output_[0] = (uint64_t(c[1]) << 32) | c[0];
+    philox_output_[1] = (uint64_t(c[3]) << 32) | c[2];
+    philox_available_ = 2;
+}
@@ -0,0 +1,110 @@
+#ifndef GENERATOR_CONTEXT_H
+#define GENERATOR_CONTEXT_H
+
+#include <cstdint>
+#include <random>
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Engine used when none is requested explicitly
+#define DEFAULT_RNG_ENGINE RNG_XOSHIRO256SS
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Pseudo-random engines a generator context can run on
+typedef enum {
+    RNG_MT19937_64,     // std::mt19937_64, 2.5 KB of state, expensive to reseed
+    RNG_XOSHIRO256SS,   // xoshiro256** [6], 32 bytes of state
+    RNG_PHILOX4X32      // Philox4x32-10 [7], counter based: every (seed, stream) pair is an independent stream
+} RngEngine;
+
+// Random state shared by all generator stages of a task set. It is created once (e.g. per worker)
+// and reseeded per task set, so that any task set can be replayed from its (seed, stream) pair.
+class GeneratorContext {
+public:
+    typedef uint64_t result_type;
+
+    // Seeds from std::random_device (non-reproducible runs)
+    explicit GeneratorContext(RngEngine engine = DEFAULT_RNG_ENGINE);
+    GeneratorContext(uint64_t seed, uint64_t stream = 0, RngEngine engine = DEFAULT_RNG_ENGINE);
+
+    // Restarts the engine on stream 'stream' of 'seed'
+    void seed(uint64_t seed, uint64_t stream = 0);
+
+    uint64_t seed_value() const { return seed_; }
+    uint64_t stream_value() const { return stream_; }
+    RngEngine engine() const { return engine_; }
+
+    // Next 64 random bits
+    uint64_t next_u64();
+
+    // Uniform double in [0, 1) built from the upper 53 bits, identical on every platform
+    double uniform() { return (next_u64() >> 11) * 0x1.0p-53; }
+
+    // Uniform double in [a, b)
+    double uniform(double a, double b) { return a + (b - a) * uniform(); }
+
+    // UniformRandomBitGenerator interface, for use with <random> distributions
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return next_u64(); }
+
+private:
+    void philox_refill();
+
+    RngEngine engine_;
+    uint64_t seed_ = 0;
+    uint64_t stream_ = 0;
+
+    std::mt19937_64 mt_;
+    uint64_t xoshiro_[4] = {};
+    uint64_t philox_counter_ = 0;
+    uint64_t philox_output_[2] = {};
+    int philox_available_ = 0;
+};
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// splitmix64 hash of (seed, stream); used to seed the non counter-based engines
+uint64_t derive_stream_seed(uint64_t seed, uint64_t stream);
+
+// [6] D. Blackman, S. Vigna, "Scrambled linear pseudorandom number generators", ACM TOMS 47(4), 2021
+// [7] J. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC 2011
+
+// ================
+// INLINE FUNCTIONS
+// ================
+
+inline uint64_t GeneratorContext::next_u64() {
+    switch (engine_) {
+        case RNG_XOSHIRO256SS: {
+            uint64_t* s = xoshiro_;
+            uint64_t x = s[1] * 5;
+            uint64_t result = ((x << 7) | (x >> 57)) * 9;
+            uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = (s[3] << 45) | (s[3] >> 19);
+            return result;
+        }
+        case RNG_PHILOX4X32:
+            if (philox_available_ == 0) {
+                philox_refill();
+            }
+            return philox_output_[--philox_available_];
+        case RNG_MT19937_64:
+        default:
+            return mt_();
+    }
+}
+
+#endif
@@ -1,12 +1,113 @@
 #ifndef MULTI_PHASE_H
 #define MULTI_PHASE_H
 
+#include <cstddef>
 #include <vector>
 #include "multi_phase_generator.h"
+#include "multi_phase_bound.h"
+#include "multi_phase_taskset.h"
+#include "multi_phase_corpus.h"
 
-bool scheduling_algorithm(std::vector<Tasks>& tasks);
-double compute_max_blocking(std::vector<Tasks>& tasks, int td);
-double compute_dbf(Tasks task, int td);
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
 
+// Next deadline point of one task while the per-task deadline sequences are merged
+template <class Time>
+struct BasicDeadlineEvent {
+    Time point;         // grid_ceil(job * Ti + Di)
+    int task;           // Task index
+    long long job;      // Job number k
+};
 
-#endif
\ No newline at end of file
+// How the analysis of a task set ended
+typedef enum {
+    ANALYSIS_SCHEDULABLE,
+    ANALYSIS_DEMAND_EXCEEDED,       // dbf(td) > td at a deadline point inside the beta window (delta < 0)
+    ANALYSIS_CLEANUP_EXCEEDS_BETA,  // A phase's clean up cost does not fit into the task's beta
+    ANALYSIS_OVERLOADED,            // Demand utilization above 1
+    ANALYSIS_DEMAND_BEYOND_WINDOW,  // dbf(td) > td at a deadline point between max(D_i) and the testing bound
+    ANALYSIS_BOUND_BEYOND_HORIZON   // The testing bound lies past TimeTraits::horizon(), so the demand cannot be checked up to it
+} AnalysisVerdict;
+
+// Stage of analyze_taskset_tiered() that decided a task set (multi_phase_filter.h)
+typedef enum {
+    TIER_UTILIZATION,               // Rejected: demand utilization above 1
+    TIER_FIRST_POINT,               // Rejected at the first deadline point, as the exact test would
+    TIER_DENSITY,                   // Accepted: density bound on the dbf leaves room for every clean up cost
+    TIER_APPROX_DBF,                // Accepted: same with a dbf that is exact for the first jobs and linear after
+    TIER_EXACT                      // Decided by the full deadline-point analysis
+} AnalysisTier;
+
+// Structured outcome of analyze_taskset(); the per-task beta is left in the scratch's beta_per_task
+template <class Time>
+struct BasicAnalysisResult {
+    AnalysisVerdict verdict = ANALYSIS_SCHEDULABLE;
+    AnalysisTier tier = TIER_EXACT;                 // Beta and chunk counts are only computed for TIER_EXACT
+    Time failing_td = TimeTraits<Time>::zero();     // Deadline point at which the test failed (never() for ANALYSIS_OVERLOADED)
+    Time delta = TimeTraits<Time>::zero();          // td - dbf(td) at failing_td
+    int failing_task = -1;                          // Task whose beta was exceeded (ANALYSIS_CLEANUP_EXCEEDS_BETA)
+};
+
+// Working memory of the analysis. Kept by the caller and reused across task sets, so that once it
+// has grown to the largest task set seen, analysing further task sets does not allocate.
+template <class Time>
+struct BasicAnalysisScratch {
+    BasicTaskSet<Time> taskset;
+    std::vector<Time> deadline_points;
+    std::vector<BasicDeadlineEvent<Time>> heap;
+    std::vector<Time> point_demand;
+    std::vector<Time> chunk_beta;
+    std::vector<Time> beta_per_task;                // Results: beta of every task
+    std::vector<int> intervals_per_task_phase;      // Results: chunk count of phase j of task i at [i * MAX_PHASES + j]
+    BasicAnalysisResult<Time> result;               // Results: verdict of the last analysis
+};
+
+typedef BasicDeadlineEvent<double> DeadlineEvent;
+typedef BasicAnalysisResult<double> AnalysisResult;
+typedef BasicAnalysisScratch<double> AnalysisScratch;
+typedef BasicAnalysisScratch<Ticks> TickAnalysisScratch;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Multi-phase schedulability test of tasks[0 .. num_tasks); prints nothing and leaves the result, beta
+// and the chunk counts in 'scratch'. The TickTask overload runs the same test in exact integer arithmetic,
+// the TaskRecord overload reads the records of a mapped corpus in place.
+// Both instantiate analyze_basic_taskset_dispatch() from multi_phase_core.h, which other time types can use directly.
+bool analyze_taskset(const Tasks* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch);
+bool analyze_taskset(const TickTask* tasks, size_t num_tasks, TestingBound bound, TickAnalysisScratch& scratch);
+bool analyze_taskset(const TaskRecord* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch);
+
+// Processor-demand condition for the deadline points in (window, L], L given by 'bound'. The scratch
+// buffers are used for the point list and, on failure, the result; 'taskset' is not read from the scratch.
+bool demand_test_beyond_window(const TaskSet& taskset, double window, TestingBound bound, AnalysisScratch& scratch);
+
+// Convenience wrapper around analyze_taskset() with its own scratch; copies the outcome to *result if given
+bool scheduling_algorithm(std::vector<Tasks>& tasks, TestingBound bound = DEFAULT_TESTING_BOUND, AnalysisResult* result = nullptr);
+
+// Same verdict as analyze_taskset(), but the cheap pre-filters of multi_phase_filter.h run first and
+// the exact analysis only runs on the task sets they cannot decide. scratch.result.tier tells which
+// stage decided; the verdict of a rejecting filter can name a different (also true) reason than the
+// exact test would have, and beta and the chunk counts are left untouched unless the tier is TIER_EXACT.
+bool analyze_taskset_tiered(const Tasks* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch);
+bool analyze_taskset_tiered(const TaskRecord* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch);
+
+// Name of a verdict as used in reports, e.g. "demand_exceeded"
+const char* analysis_verdict_name(AnalysisVerdict verdict);
+
+// Name of an analysis tier, e.g. "density"
+const char* analysis_tier_name(AnalysisTier tier);
+
+double compute_max_blocking(const std::vector<Tasks>& tasks, int td);
+double compute_dbf(const Tasks& task, double td);
+
+// Minimum number of chunks a phase with the given WCET and clean up cost must be split into so that
+// every chunk plus its clean up fits into beta (requires beta > cleanup)
+int compute_min_chunks(double wcet, double cleanup, double beta);
+
+// Absolute deadlines k*T_i + D_i in (from, window], rounded up to integer time points, sorted and without duplicates
+void enumerate_deadline_points(const TaskSet& taskset, double from, double window, std::vector<double>& points, std::vector<DeadlineEvent>& heap);
+
+#endif
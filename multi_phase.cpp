@@ -1,24 +1,25 @@
-#include <iostream>
 #include <vector>
 #include <algorithm>
 #include <random>
 #include <cassert>
 #include <cmath>
-#include "multi-phase.h"
+#include <climits>
+#include "multi_phase_filter.h"
 using namespace std;
 
 
-double compute_dbf(Tasks task, double td) {
+double compute_dbf(const Tasks& task, double td) {
     double dbf = max(floor((td - task.deadline) / task.period) + 1, 0.0) * task.wcet;
     return dbf;
 }
 
-double compute_max_blocking(vector<Tasks>& tasks, int td) {
+double compute_max_blocking(const vector<Tasks>& tasks, int td) {
     // Compute slack as per Eqn 7
     double dbf_task_set = 0.0;
-    for(auto task:tasks) {
+    INSTRUMENT_COUNT(COUNTER_DBF_EVALUATIONS, 1);
+    for(const Tasks& task:tasks) {
         double dbf_task = 0.0;
-        if(task.deadline < (double)td) {
+        if(task.deadline <= (double)td) {
             dbf_task = compute_dbf(task, (double)td);
         }
         dbf_task_set += dbf_task;
@@ -29,83 +30,101 @@ double compute_max_blocking(vector<Tasks>& tasks, int td) {
 }
 
 
-bool scheduling_algorithm(vector<Tasks>& tasks) {
-    int total_tasks = tasks.size();
+void enumerate_deadline_points(const TaskSet& taskset, double from, double window, vector<double>& points, vector<DeadlineEvent>& heap) {
+    enumerate_deadline_points<double>(taskset, from, window, points, heap);
+}
+
 
-    vector<vector<int>> intervals_per_task_phase (total_tasks, vector<int>(NUM_PHASES, 1)); // To denote cnt(v(i,j)) the maximum number of contiguous time-intervals in which the jth phase of a task executes
-    vector<double> beta_per_task (total_tasks, 0.0); // To denote the maximum time for which a task will execute non-preemptively (beta)
-    vector<int> deadlines;
-    double max_testing_time = 0.0;
-    for (int i=0; i<total_tasks; i++) {
-        beta_per_task[i] = tasks[i].wcet + tasks[i].cleanup; // We need to take the maximum value among all phases. However, as we assume same values for all phases, it is equivalent to this.
-        max_testing_time = max(max_testing_time, tasks[i].deadline);
-        deadlines.push_back(ceil(tasks[i].deadline));
+int compute_min_chunks(double wcet, double cleanup, double beta) {
+    // Smallest k >= 1 with wcet/k + cleanup <= beta, i.e. k = ceil(wcet / (beta - cleanup)).
+    // The estimate is corrected against the exact predicate so rounding cannot shift it by one.
+    assert(beta > cleanup);
+    double estimate = ceil(wcet / (beta - cleanup));
+    if (!(estimate < INT_MAX)) {
+        return INT_MAX;
     }
-    int max_testing_time_int  = int(max_testing_time); // Only need to consider integer values
-    for (int td=1; td<=max_testing_time_int; td++) {
-        if(count(deadlines.begin(), deadlines.end(), td) > 0) {
-            double delta_td = compute_max_blocking(tasks, td);
-
-            if (delta_td < 0) {
-                cout << "THE SYSTEM IS NOT SCHEDULABLE" << endl;
-                return false;
-            }
-
-            for (int i=0; i<total_tasks; i++) {
-                if (tasks[i].deadline > td) {
-                    if (beta_per_task[i] - 1 > delta_td) {
-                        beta_per_task[i] = delta_td + 1;
-                    }
-                    for (int j = 1; j <= NUM_PHASES; j++) {
-                        if (beta_per_task[i] > tasks[i].cleanup) {
-                            int min_chunks = 1;
-                            while ((tasks[i].wcet/min_chunks) + tasks[i].cleanup > beta_per_task[i]) {
-                                min_chunks++;
-                            }
-                            intervals_per_task_phase[i][j] = min_chunks;
-                        } else {
-                            cout << "THE SYSTEM IS NOT SCHEDULABLE" << endl;
-                            return false;
-                        }
-                    }
-                }
-            }
-        }
+    int min_chunks = max(int(estimate), 1);
+    INSTRUMENT_COUNT(COUNTER_CHUNK_SEARCH_STEPS, 1);
+    while ((wcet/min_chunks) + cleanup > beta) {
+        min_chunks++;
+        INSTRUMENT_COUNT(COUNTER_CHUNK_SEARCH_STEPS, 1);
+    }
+    while (min_chunks > 1 && (wcet/(min_chunks - 1)) + cleanup <= beta) {
+        min_chunks--;
+        INSTRUMENT_COUNT(COUNTER_CHUNK_SEARCH_STEPS, 1);
     }
+    return min_chunks;
+}
+
 
-    cout << "THE SYSTEM IS SCHEDULABLE" << endl;
-    return true;
+bool analyze_taskset(const Tasks* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch) {
+    return analyze_basic_taskset_dispatch(tasks, num_tasks, bound, scratch);
 }
 
-int main() {
-
-    // Generate tasks
-    int total_scheduled = 0;
-    int total_non_scheduled = 0;
-
-
-    // Display generated tasks
-    for(int num_tasksets=0; num_tasksets<NUM_TASKSETS; num_tasksets++) {
-        std::vector<Tasks> tasks = generate_tasks();
-        std::cout << "Generated Tasks:\n";
-        for (int i = 0; i < NUM_TASKS; ++i) {
-            std::cout << "Task " << i+1 << ":\n";
-            std::cout << "Utilization: " << tasks[i].utilization << ", ";
-            std::cout << "Period: " << tasks[i].period << ", ";
-            std::cout << "WCET: " << tasks[i].wcet << ", ";
-            std::cout << "Trust Probability: " << tasks[i].ptrust << ", ";
-            std::cout << "Cleanup: " << tasks[i].cleanup << ", ";
-            std::cout << "Deadline: " << tasks[i].deadline << "\n";
-        }
-        cout<<"Task Num: "<<num_tasksets<<" ";
-        bool scheduled = scheduling_algorithm(tasks);
-        if(scheduled) {
-            total_scheduled ++;
-        } else {
-            total_non_scheduled ++;
-        }
+bool analyze_taskset(const TickTask* tasks, size_t num_tasks, TestingBound bound, TickAnalysisScratch& scratch) {
+    return analyze_basic_taskset_dispatch(tasks, num_tasks, bound, scratch);
+}
+
+bool analyze_taskset(const TaskRecord* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch) {
+    return analyze_basic_taskset_dispatch(tasks, num_tasks, bound, scratch);
+}
+
+
+bool analyze_taskset_tiered(const Tasks* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch) {
+    return analyze_basic_taskset_tiered(tasks, num_tasks, bound, scratch);
+}
+
+bool analyze_taskset_tiered(const TaskRecord* tasks, size_t num_tasks, TestingBound bound, AnalysisScratch& scratch) {
+    return analyze_basic_taskset_tiered(tasks, num_tasks, bound, scratch);
+}
+
+
+bool demand_test_beyond_window(const TaskSet& taskset, double window, TestingBound bound, AnalysisScratch& scratch) {
+    return demand_test_beyond_window<double>(taskset, window, bound, scratch);
+}
+
+
+bool scheduling_algorithm(vector<Tasks>& tasks, TestingBound bound, AnalysisResult* result) {
+    AnalysisScratch scratch;
+    bool schedulable = analyze_taskset(tasks.data(), tasks.size(), bound, scratch);
+    if (result != nullptr) {
+        *result = scratch.result;
     }
-    cout<<"Total scheduled are: "<<total_scheduled<<" Total non-scheduled are: "<<total_non_scheduled<<endl;
-    return 0;
+    return schedulable;
 }
 
+
+const char* analysis_verdict_name(AnalysisVerdict verdict) {
+    switch (verdict) {
+        case ANALYSIS_SCHEDULABLE:
+            return "schedulable";
+        case ANALYSIS_DEMAND_EXCEEDED:
+            return "demand_exceeded";
+        case ANALYSIS_CLEANUP_EXCEEDS_BETA:
+            return "cleanup_exceeds_beta";
+        case ANALYSIS_OVERLOADED:
+            return "overloaded";
+        case ANALYSIS_DEMAND_BEYOND_WINDOW:
+            return "demand_beyond_window";
+        case ANALYSIS_BOUND_BEYOND_HORIZON:
+            return "bound_beyond_horizon";
+    }
+    return "unknown";
+}
+
+
+const char* analysis_tier_name(AnalysisTier tier) {
+    switch (tier) {
+        case TIER_UTILIZATION:
+            return "utilization";
+        case TIER_FIRST_POINT:
+            return "first_point";
+        case TIER_DENSITY:
+            return "density";
+        case TIER_APPROX_DBF:
+            return "approx_dbf";
+        case TIER_EXACT:
+            return "exact";
+    }
+    return "unknown";
+}
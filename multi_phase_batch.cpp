@@ -0,0 +1,32 @@
+#include <vector>
+#include <algorithm>
+#include "multi_phase_batch.h"
+
+void analyze_batch(const TasksetBatch& batch, AnalysisScratch& scratch, BatchResults& results, TestingBound bound) {
+
+    for (size_t k = 0; k < batch.num_tasksets; k++) {
+        size_t first = batch.offsets[k];
+        size_t num_tasks = batch.offsets[k + 1] - first;
+
+        bool schedulable = analyze_taskset(batch.tasks + first, num_tasks, bound, scratch);
+
+        if (results.schedulable != nullptr) {
+            results.schedulable[k] = schedulable;
+        }
+        if (results.beta_per_task != nullptr) {
+            std::copy(scratch.beta_per_task.begin(), scratch.beta_per_task.end(), results.beta_per_task + first);
+        }
+        if (results.chunks_per_task_phase != nullptr) {
+            std::copy(scratch.intervals_per_task_phase.begin(), scratch.intervals_per_task_phase.end(),
+                      results.chunks_per_task_phase + first * MAX_PHASES);
+        }
+    }
+}
+
+void append_taskset(const std::vector<Tasks>& taskset, std::vector<Tasks>& tasks, std::vector<size_t>& offsets) {
+    if (offsets.empty()) {
+        offsets.push_back(0);
+    }
+    tasks.insert(tasks.end(), taskset.begin(), taskset.end());
+    offsets.push_back(tasks.size());
+}
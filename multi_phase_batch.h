@@ -0,0 +1,38 @@
+#ifndef MULTI_PHASE_BATCH_H
+#define MULTI_PHASE_BATCH_H
+
+#include <cstddef>
+#include <vector>
+#include "multi-phase.h"
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Many task sets stored back to back in one flat buffer: task set k is tasks[offsets[k] .. offsets[k + 1])
+typedef struct TasksetBatch {
+    const Tasks* tasks = nullptr;
+    const size_t* offsets = nullptr;        // num_tasksets + 1 entries, offsets[0] == 0
+    size_t num_tasksets = 0;
+} TasksetBatch;
+
+// Caller-owned result arrays; any of them may be null if that output is not needed
+typedef struct BatchResults {
+    bool* schedulable = nullptr;            // [num_tasksets]
+    double* beta_per_task = nullptr;        // [offsets[num_tasksets]], parallel to the task buffer
+    int* chunks_per_task_phase = nullptr;   // [offsets[num_tasksets] * MAX_PHASES]
+} BatchResults;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Runs the multi-phase test on every task set of the batch. All working memory comes from 'scratch',
+// so in steady state (scratch already sized for the largest task set) no heap allocation happens.
+void analyze_batch(const TasksetBatch& batch, AnalysisScratch& scratch, BatchResults& results,
+                   TestingBound bound = DEFAULT_TESTING_BOUND);
+
+// Appends a task set to a batch under construction (tasks and offsets are the batch's backing storage)
+void append_taskset(const std::vector<Tasks>& taskset, std::vector<Tasks>& tasks, std::vector<size_t>& offsets);
+
+#endif
@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "multi-phase.h"
+#include "multi_phase_partition.h"
+#include "multi_phase_cosched.h"
+#include "multi_phase_dbf_cache.h"
+#include "multi_phase_bench.h"
+
+// Every operator new in the process is counted, so a benchmark can report allocations per call.
+// The aligned forms are counted too: AlignedAllocator gets the task set arrays from them.
+
+static std::atomic<long long> allocation_count(0);
+
+static void* counted_allocation(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+static void* counted_aligned_allocation(std::size_t size, std::align_val_t alignment) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t bytes = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void* ptr = std::aligned_alloc(align, bytes)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) {
+    return counted_allocation(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_allocation(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_aligned_allocation(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_aligned_allocation(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+// Keeps the optimizer from discarding a benchmarked result
+
+static volatile double bench_sink;
+
+// Runs 'body' (one operation per call) until both the minimum time and the minimum iteration count are reached
+
+template <class Body>
+static BenchResult run_case(const char* name, const BenchOptions& options, Body body) {
+
+    typedef std::chrono::steady_clock Clock;
+    body(); // Warm up caches and scratch buffers, so steady-state allocations are measured
+
+    BenchResult result;
+    result.name = name;
+    long long allocations = allocation_count.load(std::memory_order_relaxed);
+    Clock::time_point start = Clock::now();
+    double elapsed_ns = 0.0;
+    long long iterations = 0;
+    for (long long batch = 1; ; batch *= 2) {
+        for (long long k = 0; k < batch; k++) {
+            body();
+        }
+        iterations += batch;
+        elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (elapsed_ns >= options.min_time_ms * 1e6 && iterations >= BENCH_MIN_ITERATIONS) {
+            break;
+        }
+    }
+
+    result.iterations = iterations;
+    result.ns_per_op = elapsed_ns / iterations;
+    result.ops_per_second = 1e9 / result.ns_per_op;
+    result.allocations_per_op = double(allocation_count.load(std::memory_order_relaxed) - allocations) / iterations;
+    return result;
+}
+
+// generate_tasks() for any task count, period range and utilization. The utilizations are not rounded:
+// the legacy sampler rounds each share to two decimals, which leaves large task sets without load.
+
+static void generate_bench_tasks(GeneratorContext& ctx, UtilizationSampler& sampler, int num_tasks, double period_ratio,
+                                 double utilization, std::vector<Tasks>& tasks) {
+    GeneratorParams params;
+    params.num_tasks = num_tasks;
+    params.max_utilization = utilization;
+    params.min_period = BENCH_MIN_PERIOD;
+    params.max_period = BENCH_MIN_PERIOD * period_ratio;
+    params.utilization_algorithm = BENCH_UTILIZATION_ALGORITHM;
+    generate_tasks(ctx, params, sampler, tasks);
+}
+
+static void run_benchmarks(const BenchOptions& options, std::vector<BenchResult>& results) {
+
+    std::vector<int> task_counts = {4, 8, 16, 32, 64, 128, 256, 512, 1000};
+    std::vector<double> period_ratios = {10.0, 100.0, 1000.0};
+    std::vector<double> utilizations = {0.5, 0.75, 0.95};
+    if (options.quick) {
+        task_counts = {4, 64};
+        period_ratios = {10.0};
+        utilizations = {MAX_UTILIZATION};
+    }
+
+    GeneratorContext ctx(options.seed);
+    UtilizationSampler task_sampler;
+    std::vector<Tasks> tasks;
+    AnalysisScratch scratch;
+
+    // Single-call kernels on the default task set shape
+    generate_tasks(ctx, tasks);
+    results.push_back(run_case("compute_dbf", options, [&]() {
+        bench_sink = compute_dbf(tasks[0], ctx.uniform(0.0, MAX_PERIOD));
+    }));
+    results.back().num_tasks = 1;
+
+    results.push_back(run_case("generate_tasks", options, [&]() {
+        std::vector<Tasks> generated = generate_tasks(ctx);
+        bench_sink = generated[0].wcet;
+    }));
+    results.push_back(run_case("generate_tasks_random_device", options, [&]() {
+        std::vector<Tasks> generated = generate_tasks();
+        bench_sink = generated[0].wcet;
+    }));
+    for (BenchResult* result : {&results[results.size() - 2], &results.back()}) {
+        result->num_tasks = NUM_TASKS;
+        result->period_ratio = double(MAX_PERIOD) / MIN_PERIOD;
+        result->utilization = MAX_UTILIZATION;
+    }
+
+    results.push_back(run_case("scheduling_algorithm", options, [&]() {
+        bench_sink = scheduling_algorithm(tasks);
+    }));
+    results.back().num_tasks = NUM_TASKS;
+    results.back().period_ratio = double(MAX_PERIOD) / MIN_PERIOD;
+    results.back().utilization = MAX_UTILIZATION;
+
+    // Scaling sweeps
+    for (int num_tasks : task_counts) {
+        for (double utilization : utilizations) {
+            tasks.assign(num_tasks, Tasks());
+            results.push_back(run_case("generate_task_utilizations", options, [&]() {
+                generate_task_utilizations(tasks, utilization, ctx);
+                bench_sink = tasks[0].utilization;
+            }));
+            results.back().num_tasks = num_tasks;
+            results.back().utilization = utilization;
+
+            // The same draw with the algorithms of multi_phase_utilization.h, one vector and a batch per call
+            for (UtilizationAlgorithm algorithm : {UTIL_UUNIFAST_ROUNDED, UTIL_UUNIFAST, UTIL_UUNIFAST_DISCARD, UTIL_RANDFIXEDSUM}) {
+                static const char* const names[] = {"uunifast_rounded", "uunifast", "uunifast_discard", "randfixedsum"};
+                UtilizationSampler sampler(algorithm, num_tasks, utilization);
+                std::vector<double> out(std::size_t(num_tasks) * BENCH_UTILIZATION_BATCH);
+                results.push_back(run_case((std::string("utilizations_") + names[algorithm]).c_str(), options, [&]() {
+                    sampler.sample(ctx, out.data());
+                    bench_sink = out[0];
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().utilization = utilization;
+
+                results.push_back(run_case((std::string("utilizations_batch_") + names[algorithm]).c_str(), options, [&]() {
+                    sampler.sample_batch(ctx, BENCH_UTILIZATION_BATCH, out.data());
+                    bench_sink = out[0];
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().utilization = utilization;
+            }
+        }
+
+        // Multiprocessor totals (a quarter and half of the task count) only the unbounded algorithms support
+        for (double share : {0.25, 0.5}) {
+            for (UtilizationAlgorithm algorithm : {UTIL_UUNIFAST_DISCARD, UTIL_RANDFIXEDSUM}) {
+                double total = share * num_tasks;
+                if (total <= 1.0) {
+                    continue;
+                }
+                UtilizationSampler sampler(algorithm, num_tasks, total);
+                std::vector<double> out(num_tasks);
+                results.push_back(run_case(algorithm == UTIL_RANDFIXEDSUM ? "utilizations_randfixedsum" : "utilizations_uunifast_discard",
+                                           options, [&]() {
+                    sampler.sample(ctx, out.data());
+                    bench_sink = out[0];
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().utilization = total;
+            }
+        }
+
+        // Partitioning onto multicores with all heuristics, from task sets with unrounded utilizations
+        for (int num_cores : BENCH_PARTITION_CORES) {
+            GeneratorParams params;
+            params.num_tasks = num_tasks;
+            params.max_utilization = BENCH_PARTITION_LOAD * num_cores;
+            params.utilization_algorithm = UTIL_RANDFIXEDSUM;
+            if (num_tasks < 2 * num_cores) {
+                continue;
+            }
+            UtilizationSampler sampler;
+            std::vector<std::vector<Tasks>> pool(BENCH_TASKSET_POOL);
+            for (int k = 0; k < BENCH_TASKSET_POOL; k++) {
+                GeneratorContext pool_ctx(options.seed, k + 1);
+                generate_tasks(pool_ctx, params, sampler, pool[k]);
+            }
+            std::size_t next = 0;
+            PartitionResult partition;
+            results.push_back(run_case("partition_tasks", options, [&]() {
+                bench_sink = partition_tasks(pool[next++ % BENCH_TASKSET_POOL], num_cores, PartitionOptions(), &partition);
+            }));
+            results.back().num_tasks = num_tasks;
+            results.back().utilization = params.max_utilization;
+            results.back().num_cores = num_cores;
+
+            CoScheduleResult placement;
+            results.push_back(run_case("co_schedule_tasks", options, [&]() {
+                bench_sink = co_schedule_tasks(pool[next++ % BENCH_TASKSET_POOL], num_cores, CoScheduleOptions(), &placement);
+            }));
+            results.back().num_tasks = num_tasks;
+            results.back().utilization = params.max_utilization;
+            results.back().num_cores = num_cores;
+        }
+
+        for (double period_ratio : period_ratios) {
+            for (double utilization : utilizations) {
+                results.push_back(run_case("generate_pipeline", options, [&]() {
+                    generate_bench_tasks(ctx, task_sampler, num_tasks, period_ratio, utilization, tasks);
+                    bench_sink = tasks[0].deadline;
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().period_ratio = period_ratio;
+                results.back().utilization = utilization;
+
+                // Analysis inputs are drawn once, from a fixed stream per case
+                std::vector<std::vector<Tasks>> pool(BENCH_TASKSET_POOL);
+                for (int k = 0; k < BENCH_TASKSET_POOL; k++) {
+                    GeneratorContext pool_ctx(options.seed, k + 1);
+                    generate_bench_tasks(pool_ctx, task_sampler, num_tasks, period_ratio, utilization, pool[k]);
+                }
+
+                std::size_t next = 0;
+                results.push_back(run_case("compute_max_blocking", options, [&]() {
+                    const std::vector<Tasks>& taskset = pool[next++ % BENCH_TASKSET_POOL];
+                    bench_sink = compute_max_blocking(taskset, int(BENCH_MIN_PERIOD * period_ratio));
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().period_ratio = period_ratio;
+                results.back().utilization = utilization;
+
+                next = 0;
+                results.push_back(run_case("analyze_taskset", options, [&]() {
+                    const std::vector<Tasks>& taskset = pool[next++ % BENCH_TASKSET_POOL];
+                    bench_sink = analyze_taskset(taskset.data(), taskset.size(), DEFAULT_TESTING_BOUND, scratch);
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().period_ratio = period_ratio;
+                results.back().utilization = utilization;
+
+                next = 0;
+                results.push_back(run_case("analyze_taskset_tiered", options, [&]() {
+                    const std::vector<Tasks>& taskset = pool[next++ % BENCH_TASKSET_POOL];
+                    bench_sink = analyze_taskset_tiered(taskset.data(), taskset.size(), DEFAULT_TESTING_BOUND, scratch);
+                }));
+                results.back().num_tasks = num_tasks;
+                results.back().period_ratio = period_ratio;
+                results.back().utilization = utilization;
+
+                // Design-space exploration: every task set differs from the one before in a single task
+                std::vector<std::vector<Tasks>> explore(BENCH_TASKSET_POOL, pool[0]);
+                for (int k = 1; k < BENCH_TASKSET_POOL; k++) {
+                    explore[k] = explore[k - 1];
+                    explore[k][k % num_tasks] = pool[k][k % num_tasks];
+                }
+                for (bool cached : {false, true}) {
+                    DbfCache cache;
+                    next = 0;
+                    results.push_back(run_case(cached ? "explore_analyze_cached" : "explore_analyze_taskset", options, [&]() {
+                        const std::vector<Tasks>& taskset = explore[next++ % BENCH_TASKSET_POOL];
+                        bench_sink = cached ? analyze_taskset_cached(taskset.data(), taskset.size(), DEFAULT_TESTING_BOUND, cache, scratch)
+                                            : analyze_taskset(taskset.data(), taskset.size(), DEFAULT_TESTING_BOUND, scratch);
+                    }));
+                    results.back().num_tasks = num_tasks;
+                    results.back().period_ratio = period_ratio;
+                    results.back().utilization = utilization;
+                }
+            }
+        }
+    }
+}
+
+static void print_csv(const std::vector<BenchResult>& results) {
+    std::cout << "benchmark,num_tasks,period_ratio,utilization,iterations,ns_per_op,ops_per_second,allocations_per_op,num_cores\n";
+    for (const BenchResult& r : results) {
+        std::cout << r.name << "," << r.num_tasks << "," << r.period_ratio << "," << r.utilization << ","
+                  << r.iterations << "," << r.ns_per_op << "," << r.ops_per_second << "," << r.allocations_per_op << "," << r.num_cores << "\n";
+    }
+}
+
+static void print_json(const std::vector<BenchResult>& results, const BenchOptions& options) {
+    std::cout << "{\n  \"seed\": " << options.seed << ",\n  \"min_time_ms\": " << options.min_time_ms << ",\n  \"results\": [\n";
+    for (std::size_t k = 0; k < results.size(); k++) {
+        const BenchResult& r = results[k];
+        std::cout << "    {\"benchmark\": \"" << r.name << "\", \"num_tasks\": " << r.num_tasks
+                  << ", \"period_ratio\": " << r.period_ratio << ", \"utilization\": " << r.utilization
+                  << ", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.ns_per_op
+                  << ", \"ops_per_second\": " << r.ops_per_second << ", \"allocations_per_op\": " << r.allocations_per_op << ", \"num_cores\": " << r.num_cores
+                  << "}" << (k + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+
+    // Usage: multi_phase_bench [--json] [--quick] [--min-time MS] [--seed N]
+    BenchOptions options;
+    for (int k = 1; k < argc; k++) {
+        if (std::strcmp(argv[k], "--json") == 0) {
+            options.json = true;
+        } else if (std::strcmp(argv[k], "--quick") == 0) {
+            options.quick = true;
+        } else if (std::strcmp(argv[k], "--min-time") == 0 && k + 1 < argc) {
+            options.min_time_ms = std::strtod(argv[++k], nullptr);
+        } else if (std::strcmp(argv[k], "--seed") == 0 && k + 1 < argc) {
+            options.seed = std::strtoull(argv[++k], nullptr, 0);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--json] [--quick] [--min-time MS] [--seed N]\n";
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    run_benchmarks(options, results);
+
+    if (options.json) {
+        print_json(results, options);
+    } else {
+        print_csv(results);
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#ifndef MULTI_PHASE_BENCH_H
+#define MULTI_PHASE_BENCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "multi_phase_generator.h"
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Minimum measured time per benchmark case, in milliseconds (the case is repeated until it is reached)
+#define BENCH_MIN_TIME_MS 50
+
+// Minimum number of repetitions per benchmark case
+#define BENCH_MIN_ITERATIONS 3
+
+// Number of pre-generated task sets the analysis benchmarks cycle through
+#define BENCH_TASKSET_POOL 64
+
+// Seed of all benchmark inputs, so that runs on different machines measure the same task sets
+#define BENCH_SEED 0xbe7cULL
+
+// Utilization vectors drawn per call by the batch generation benchmarks
+#define BENCH_UTILIZATION_BATCH 1024
+
+// Core counts of the partitioning benchmark; each case targets a total utilization of
+// BENCH_PARTITION_LOAD per core
+#define BENCH_PARTITION_CORES {4, 16}
+#define BENCH_PARTITION_LOAD 0.5
+
+// Lower period bound of the period-ratio sweep (the upper bound is BENCH_MIN_PERIOD * ratio)
+#define BENCH_MIN_PERIOD MIN_PERIOD
+
+// Utilization algorithm of the generated task sets; unrounded, so every task count carries its load
+#define BENCH_UTILIZATION_ALGORITHM UTIL_UUNIFAST
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// One measured benchmark case. Parameters that do not apply to a benchmark are 0.
+typedef struct BenchResult {
+    std::string name;
+    int num_tasks = 0;
+    double period_ratio = 0.0;      // MAX_PERIOD / MIN_PERIOD of the generated task sets
+    double utilization = 0.0;       // Total utilization handed to UUniFast
+    long long iterations = 0;
+    double ns_per_op = 0.0;
+    double ops_per_second = 0.0;    // Task sets per second for the per-task-set benchmarks
+    double allocations_per_op = 0.0;
+    int num_cores = 0;              // Cores the partitioning benchmarks place the task set on
+} BenchResult;
+
+// Command line options of the benchmark driver
+typedef struct BenchOptions {
+    bool json = false;              // JSON instead of CSV
+    bool quick = false;             // Reduced sweep (smoke test)
+    double min_time_ms = BENCH_MIN_TIME_MS;
+    uint64_t seed = BENCH_SEED;
+} BenchOptions;
+
+#endif
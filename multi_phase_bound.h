@@ -0,0 +1,216 @@
+#ifndef MULTI_PHASE_BOUND_H
+#define MULTI_PHASE_BOUND_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include "multi_phase_taskset.h"
+#include "multi_phase_instrument.h"
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Bound used by scheduling_algorithm() when none is given explicitly
+#define DEFAULT_TESTING_BOUND BOUND_QPA
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Length of the interval over which the processor-demand condition dbf(t) <= t is checked.
+// Deadline points up to max(D_i) are always visited (they also bound beta); the bound decides
+// how far beyond that the demand condition has to be verified [4].
+typedef enum {
+    BOUND_MAX_DEADLINE,     // Legacy window max(D_i) only - not sufficient for constrained deadlines
+    BOUND_BUSY_PERIOD,      // Synchronous busy-period length Lb, every deadline point is checked
+    BOUND_LA_LB,            // min(La, Lb), every deadline point is checked
+    BOUND_QPA               // min(La, Lb), only the points visited by Quick Processor-demand Analysis [5]
+} TestingBound;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// The functions are templates over the time type of the task set (multi_phase_time.h). Deadline
+// points and testing bounds are values on the time grid; for TaskSet (double) they are integers.
+
+// Processor demand utilization U = sum(Ci / Ti) as charged by compute_dbf
+template <class Time>
+double compute_demand_utilization(const BasicTaskSet<Time>& taskset);
+
+// Length of the synchronous busy period: smallest L > 0 with L = sum(ceil(L / Ti) * Ci); at least
+// TimeTraits<Time>::horizon() if it ends past the horizon or does not end (U > 1)
+template <class Time>
+Time compute_busy_period(const BasicTaskSet<Time>& taskset);
+
+// La = max(D_1, ..., D_n, sum((Ti - Di) * Ui) / (1 - U)), only defined for U < 1 (infinity otherwise)
+template <class Time>
+double compute_la_bound(const BasicTaskSet<Time>& taskset);
+
+// Upper end of the testing interval for the chosen bound, clamped to TimeTraits<Time>::horizon().
+// *clamped (if given) tells whether the clamp cut the interval short, in which case checking up to
+// the returned bound does not prove the demand condition.
+template <class Time>
+Time compute_testing_bound(const BasicTaskSet<Time>& taskset, TestingBound bound, bool* clamped = nullptr);
+
+// Checks dbf(t) <= t for every deadline point in (from, to] by walking backwards from 'to' as in QPA [5].
+// On failure, *failing_td (if given) receives the time point at which the demand exceeded the interval.
+template <class Time>
+bool qpa_demand_test(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type from,
+                     typename BasicTaskSet<Time>::time_type to, typename BasicTaskSet<Time>::time_type* failing_td);
+
+// ====================
+// TEMPLATE DEFINITIONS
+// ====================
+
+// Processor demand utilization of the task set (cleanup is accounted through beta, not through the dbf).
+// Evaluated in double for every time type.
+
+template <class Time>
+double compute_demand_utilization(const BasicTaskSet<Time>& taskset) {
+    double util = 0.0;
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        util += TimeTraits<Time>::to_double(taskset.wcet[i]) / TimeTraits<Time>::to_double(taskset.period[i]);
+    }
+    return util;
+}
+
+// Fixed-point iteration for the synchronous busy period, starting from the total execution demand
+
+template <class Time>
+Time compute_busy_period(const BasicTaskSet<Time>& taskset) {
+
+    if (compute_demand_utilization(taskset) > 1.0) {
+        return TimeTraits<Time>::horizon(); // The busy period never ends
+    }
+
+    Time busy_period = TimeTraits<Time>::zero();
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        busy_period += taskset.wcet[i];
+    }
+
+    Time next = busy_period;
+    do {
+        busy_period = next;
+        next = TimeTraits<Time>::zero();
+        for (std::size_t i = 0; i < taskset.size(); i++) {
+            next += TimeTraits<Time>::scale(TimeTraits<Time>::ceil_div(busy_period, taskset.period[i]), taskset.wcet[i]);
+        }
+    } while (next > busy_period && next < TimeTraits<Time>::horizon());
+
+    return next;
+}
+
+// Bound La from [5]; for U >= 1 the bound does not exist and the caller has to rely on Lb
+
+template <class Time>
+double compute_la_bound(const BasicTaskSet<Time>& taskset) {
+
+    double util = compute_demand_utilization(taskset);
+    if (util >= 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double max_deadline = 0.0;
+    double weighted_slack = 0.0;
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        double period = TimeTraits<Time>::to_double(taskset.period[i]);
+        double deadline = TimeTraits<Time>::to_double(taskset.deadline[i]);
+        max_deadline = std::max(max_deadline, deadline);
+        weighted_slack += (period - deadline) * (TimeTraits<Time>::to_double(taskset.wcet[i]) / period);
+    }
+
+    return std::max(max_deadline, weighted_slack / (1.0 - util));
+}
+
+// Testing interval [1, L] for the selected bound
+
+template <class Time>
+Time compute_testing_bound(const BasicTaskSet<Time>& taskset, TestingBound bound, bool* clamped) {
+
+    Time max_deadline = TimeTraits<Time>::zero();
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        max_deadline = std::max(max_deadline, taskset.deadline[i]);
+    }
+
+    Time length = max_deadline;
+    switch (bound) {
+        case BOUND_MAX_DEADLINE:
+            break;
+        case BOUND_BUSY_PERIOD:
+            length = compute_busy_period(taskset);
+            break;
+        case BOUND_LA_LB:
+        case BOUND_QPA:
+            length = compute_busy_period(taskset);
+            if (compute_demand_utilization(taskset) < 1.0) {
+                // La is only available in double; on exact grids it is widened by one step so that
+                // its rounding can never drop a deadline point from the interval
+                double la = compute_la_bound(taskset);
+                if (la < TimeTraits<Time>::to_double(length)) {
+                    Time la_time = TimeTraits<Time>::from_double(la);
+                    if (TimeTraits<Time>::exact) {
+                        la_time += TimeTraits<Time>::unit();
+                    }
+                    length = std::min(length, la_time);
+                }
+            }
+            break;
+    }
+
+    // Deadline points lie on the grid, so the last one that matters is grid_floor(L)
+    length = std::max(length, max_deadline);
+    if (clamped != nullptr) {
+        *clamped = length >= TimeTraits<Time>::horizon();
+    }
+    return TimeTraits<Time>::grid_floor(std::min(length, TimeTraits<Time>::horizon()));
+}
+
+// Largest deadline point grid_ceil(k*Ti + Di) strictly smaller than t, or zero if there is none
+
+template <class Time>
+Time previous_deadline_point(const BasicTaskSet<Time>& taskset, Time t) {
+    Time point = TimeTraits<Time>::zero();
+    Time before = t - TimeTraits<Time>::unit();
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        if (taskset.deadline[i] <= before) {
+            long long k = TimeTraits<Time>::floor_div(before - taskset.deadline[i], taskset.period[i]);
+            point = std::max(point, TimeTraits<Time>::grid_ceil(TimeTraits<Time>::scale(k, taskset.period[i]) + taskset.deadline[i]));
+        }
+    }
+    return point;
+}
+
+// QPA: if h(t) < t then no deadline point in [h(t), t] can fail, so jump straight to h(t);
+// if h(t) == t step to the previous deadline point. Stops once the walk drops to 'from'.
+
+template <class Time>
+bool qpa_demand_test(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type from,
+                     typename BasicTaskSet<Time>::time_type to, typename BasicTaskSet<Time>::time_type* failing_td) {
+
+    Time t = to;
+    while (t > from) {
+        Time demand = taskset_dbf(taskset, t);
+        INSTRUMENT_COUNT(COUNTER_DEADLINE_POINTS, 1);
+        INSTRUMENT_COUNT(COUNTER_DBF_EVALUATIONS, 1);
+        if (demand > t) {
+            if (failing_td != nullptr) {
+                *failing_td = t;
+            }
+            return false;
+        }
+        if (demand < t) {
+            t = TimeTraits<Time>::grid_floor(demand);
+        } else {
+            t = previous_deadline_point(taskset, t);
+        }
+    }
+    return true;
+}
+
+// [4] S. Baruah, A. Mok, L. Rosier, "Preemptively scheduling hard-real-time sporadic tasks on one processor", RTSS 1990
+// [5] F. Zhang, A. Burns, "Schedulability analysis for real-time systems with EDF scheduling", IEEE TC 58(9), 2009
+
+#endif
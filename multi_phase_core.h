@@ -0,0 +1,329 @@
+#ifndef MULTI_PHASE_CORE_H
+#define MULTI_PHASE_CORE_H
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_instrument.h"
+
+// Analysis core, templated over the time type (multi_phase_time.h). analyze_taskset() instantiates
+// it for double and for integer ticks; include this header to run it on another time type, e.g.
+// FixedPoint<FIXED_POINT_FRAC_BITS>. All rounding goes through TimeTraits, so on exact time types
+// every comparison at a deadline point is decided without floating-point error.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Deadline points checked per batch beyond the window, so that the memory of the check stays bounded
+// however long the testing interval is
+#define DEADLINE_POINT_BATCH 4096
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Absolute deadlines k*T_i + D_i in (from, window], rounded up to the time grid, sorted and without duplicates
+template <class Time>
+void enumerate_deadline_points(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type from,
+                               typename BasicTaskSet<Time>::time_type window, std::vector<Time>& points,
+                               std::vector<BasicDeadlineEvent<Time>>& heap);
+
+// Same in batches: start_deadline_points() seeds the heap with the first point of every task after
+// 'from', and each next_deadline_points() call replaces 'points' with the following points, at most
+// max_points of them; false once every point up to 'window' has been returned
+template <class Time>
+void start_deadline_points(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type from,
+                           typename BasicTaskSet<Time>::time_type window, std::vector<BasicDeadlineEvent<Time>>& heap);
+template <class Time>
+bool next_deadline_points(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type window,
+                          std::size_t max_points, std::vector<Time>& points, std::vector<BasicDeadlineEvent<Time>>& heap);
+
+// compute_min_chunks() on an exact grid: k = ceil(wcet / (beta - cleanup)) needs no correction step
+template <class Time>
+int compute_min_chunks(Time wcet, Time cleanup, Time beta);
+
+// FIXED_TASKS > 0 fixes the task count at compile time (it must equal num_tasks), so that the
+// per-point loops over the tasks have constant trip counts and can be unrolled
+template <int FIXED_TASKS = 0, class Task, class Time>
+bool analyze_basic_taskset(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch);
+
+// analyze_basic_taskset() specialized for the common task counts 4, 8, 16 and 32, generic otherwise
+template <class Task, class Time>
+bool analyze_basic_taskset_dispatch(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch);
+
+template <class Time>
+bool demand_test_beyond_window(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type window,
+                               TestingBound bound, BasicAnalysisScratch<Time>& scratch);
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+#if MULTI_PHASE_INSTRUMENT
+// Adds the scratch buffers whose capacity grew while it was alive to COUNTER_ALLOCATIONS
+template <class Time>
+class ScratchGrowthProbe {
+public:
+    explicit ScratchGrowthProbe(const BasicAnalysisScratch<Time>& scratch) : scratch_(scratch) { capacities(before_); }
+    ~ScratchGrowthProbe() {
+        std::size_t after[NUM_BUFFERS];
+        capacities(after);
+        for (int b = 0; b < NUM_BUFFERS; b++) {
+            INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, after[b] > before_[b]);
+        }
+    }
+    ScratchGrowthProbe(const ScratchGrowthProbe&) = delete;
+    ScratchGrowthProbe& operator=(const ScratchGrowthProbe&) = delete;
+
+private:
+    static const int NUM_BUFFERS = 10;
+
+    void capacities(std::size_t* out) const {
+        const std::size_t sizes[NUM_BUFFERS] = {
+            scratch_.taskset.period.capacity(), scratch_.taskset.deadline.capacity(), scratch_.taskset.wcet.capacity(),
+            scratch_.taskset.cleanup.capacity(), scratch_.deadline_points.capacity(), scratch_.heap.capacity(),
+            scratch_.point_demand.capacity(), scratch_.chunk_beta.capacity(), scratch_.beta_per_task.capacity(),
+            scratch_.intervals_per_task_phase.capacity()};
+        std::copy(sizes, sizes + NUM_BUFFERS, out);
+    }
+
+    const BasicAnalysisScratch<Time>& scratch_;
+    std::size_t before_[NUM_BUFFERS];
+};
+#define INSTRUMENT_SCRATCH_GROWTH(scratch) ScratchGrowthProbe<Time> instrument_growth_probe(scratch)
+#else
+#define INSTRUMENT_SCRATCH_GROWTH(scratch) ((void)0)
+#endif
+
+// ====================
+// TEMPLATE DEFINITIONS
+// ====================
+
+// Min-heap order on the deadline point of an event
+template <class Time>
+bool later_deadline(const BasicDeadlineEvent<Time>& a, const BasicDeadlineEvent<Time>& b) {
+    return a.point > b.point;
+}
+
+template <class Time>
+void enumerate_deadline_points(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type from,
+                               typename BasicTaskSet<Time>::time_type window, std::vector<Time>& points,
+                               std::vector<BasicDeadlineEvent<Time>>& heap) {
+    start_deadline_points(taskset, from, window, heap);
+    next_deadline_points(taskset, window, std::size_t(-1), points, heap);
+}
+
+template <class Time>
+void start_deadline_points(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type from,
+                           typename BasicTaskSet<Time>::time_type window, std::vector<BasicDeadlineEvent<Time>>& heap) {
+    // Merge the per-task deadline sequences k*T_i + D_i with a min-heap so that the
+    // cost grows with the number of deadline points rather than with the window length
+    typedef TimeTraits<Time> Traits;
+    heap.clear();
+    for (int i = 0; i < static_cast<int>(taskset.size()); i++) {
+        // First job whose deadline point lies after 'from'
+        long long job = 0;
+        if (taskset.deadline[i] <= from) {
+            job = Traits::floor_div(from - taskset.deadline[i], taskset.period[i]) + 1;
+        }
+        Time first = Traits::grid_ceil(Traits::scale(job, taskset.period[i]) + taskset.deadline[i]);
+        if (first <= window) {
+            heap.push_back(BasicDeadlineEvent<Time>{std::max(first, from + Traits::unit()), i, job});
+            std::push_heap(heap.begin(), heap.end(), later_deadline<Time>);
+        }
+    }
+}
+
+template <class Time>
+bool next_deadline_points(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type window,
+                          std::size_t max_points, std::vector<Time>& points, std::vector<BasicDeadlineEvent<Time>>& heap) {
+    typedef TimeTraits<Time> Traits;
+    points.clear();
+    while (!heap.empty()) {
+        // A batch only ends before a new point, so every job at its last point has been passed
+        if (points.size() == max_points && points.back() != heap.front().point) {
+            return true;
+        }
+        std::pop_heap(heap.begin(), heap.end(), later_deadline<Time>);
+        BasicDeadlineEvent<Time>& e = heap.back();
+        if (points.empty() || points.back() != e.point) {
+            points.push_back(e.point);
+        }
+        e.job++;
+        Time next = Traits::grid_ceil(Traits::scale(e.job, taskset.period[e.task]) + taskset.deadline[e.task]);
+        if (next <= window) {
+            e.point = next;
+            std::push_heap(heap.begin(), heap.end(), later_deadline<Time>);
+        } else {
+            heap.pop_back();
+        }
+    }
+    return false;
+}
+
+template <class Time>
+int compute_min_chunks(Time wcet, Time cleanup, Time beta) {
+    // wcet/k + cleanup <= beta  <=>  wcet <= k * (beta - cleanup)
+    assert(beta > cleanup);
+    INSTRUMENT_COUNT(COUNTER_CHUNK_SEARCH_STEPS, 1);
+    long long min_chunks = TimeTraits<Time>::ceil_div(wcet, beta - cleanup);
+    return int(std::min(std::max(min_chunks, 1LL), (long long)INT_MAX));
+}
+
+template <int FIXED_TASKS, class Task, class Time>
+bool analyze_basic_taskset(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch) {
+    typedef TimeTraits<Time> Traits;
+    assert(FIXED_TASKS == 0 || static_cast<int>(num_tasks) == FIXED_TASKS);
+    const int total_tasks = FIXED_TASKS > 0 ? FIXED_TASKS : static_cast<int>(num_tasks);
+    INSTRUMENT_SCOPE(STAGE_EXACT);
+    INSTRUMENT_SCRATCH_GROWTH(scratch);
+    INSTRUMENT_COUNT(COUNTER_TASKSETS, 1);
+
+    BasicTaskSet<Time>& taskset = scratch.taskset; // Contiguous copy of the fields the dbf kernel streams over
+    load_taskset(tasks, num_tasks, taskset);
+    BasicAnalysisResult<Time>& result = scratch.result;
+    result = BasicAnalysisResult<Time>();
+
+    std::vector<int>& intervals_per_task_phase = scratch.intervals_per_task_phase; // To denote cnt(v(i,j)) the maximum number of contiguous time-intervals in which the jth phase of a task executes (row-major, MAX_PHASES per task)
+    std::vector<Time>& beta_per_task = scratch.beta_per_task; // To denote the maximum time for which a task will execute non-preemptively (beta)
+    std::vector<Time>& chunk_beta = scratch.chunk_beta; // Beta the chunk counts of a task were last computed for (never() if not yet)
+    std::vector<Time>& deadline_points = scratch.deadline_points;
+    intervals_per_task_phase.assign(num_tasks * MAX_PHASES, 1);
+    beta_per_task.assign(num_tasks, Traits::zero());
+    chunk_beta.assign(num_tasks, Traits::never());
+
+    Time max_testing_time = Traits::zero();
+    for (int i = 0; i < total_tasks; i++) {
+        assert(tasks[i].phases >= 1 && tasks[i].phases <= MAX_PHASES);
+        for (int j = 0; j < tasks[i].phases; j++) {
+            beta_per_task[i] = std::max(beta_per_task[i], task_phase_wcet(tasks[i], j) + task_phase_cleanup(tasks[i], j)); // Maximum value among all phases
+        }
+        max_testing_time = std::max(max_testing_time, tasks[i].deadline);
+    }
+    max_testing_time = Traits::grid_floor(max_testing_time); // Only need to consider points on the grid
+    enumerate_deadline_points(taskset, Traits::zero(), max_testing_time, deadline_points, scratch.heap); // The demand only changes at absolute deadlines
+    {
+        INSTRUMENT_SCOPE(STAGE_DEADLINE_LOOP);
+        for (Time td : deadline_points) {
+            Time delta_td = td - taskset_dbf(taskset, td); // Same as compute_max_blocking(tasks, td)
+            INSTRUMENT_COUNT(COUNTER_DEADLINE_POINTS, 1);
+            INSTRUMENT_COUNT(COUNTER_DBF_EVALUATIONS, 1);
+
+            if (delta_td < Traits::zero()) {
+                result.verdict = ANALYSIS_DEMAND_EXCEEDED;
+                result.failing_td = td;
+                result.delta = delta_td;
+                INSTRUMENT_COUNT(COUNTER_EARLY_EXITS, 1);
+                return false;
+            }
+
+            for (int i = 0; i < total_tasks; i++) {
+                if (tasks[i].deadline > td) {
+                    if (beta_per_task[i] - Traits::unit() > delta_td) {
+                        beta_per_task[i] = delta_td + Traits::unit();
+                    }
+                    if (beta_per_task[i] == chunk_beta[i]) {
+                        INSTRUMENT_COUNT(COUNTER_CHUNK_SKIPS, 1);
+                        continue; // Chunk counts only change with beta
+                    }
+                    chunk_beta[i] = beta_per_task[i];
+                    INSTRUMENT_SCOPE(STAGE_CHUNK_SEARCH);
+                    for (int j = 0; j < tasks[i].phases; j++) {
+                        Time cleanup = task_phase_cleanup(tasks[i], j);
+                        if (beta_per_task[i] > cleanup) {
+                            intervals_per_task_phase[i * MAX_PHASES + j] = compute_min_chunks(task_phase_wcet(tasks[i], j), cleanup, beta_per_task[i]);
+                        } else {
+                            result.verdict = ANALYSIS_CLEANUP_EXCEEDS_BETA;
+                            result.failing_td = td;
+                            result.delta = delta_td;
+                            result.failing_task = i;
+                            INSTRUMENT_COUNT(COUNTER_EARLY_EXITS, 1);
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Beta only depends on points before the largest deadline; beyond it the demand condition
+    // still has to hold up to a sufficient bound
+    return demand_test_beyond_window(taskset, max_testing_time, bound, scratch);
+}
+
+template <class Task, class Time>
+bool analyze_basic_taskset_dispatch(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch) {
+    switch (num_tasks) {
+        case 4:
+            return analyze_basic_taskset<4>(tasks, num_tasks, bound, scratch);
+        case 8:
+            return analyze_basic_taskset<8>(tasks, num_tasks, bound, scratch);
+        case 16:
+            return analyze_basic_taskset<16>(tasks, num_tasks, bound, scratch);
+        case 32:
+            return analyze_basic_taskset<32>(tasks, num_tasks, bound, scratch);
+        default:
+            return analyze_basic_taskset(tasks, num_tasks, bound, scratch);
+    }
+}
+
+template <class Time>
+bool demand_test_beyond_window(const BasicTaskSet<Time>& taskset, typename BasicTaskSet<Time>::time_type window,
+                               TestingBound bound, BasicAnalysisScratch<Time>& scratch) {
+    BasicAnalysisResult<Time>& result = scratch.result;
+    if (bound == BOUND_MAX_DEADLINE) {
+        return true;
+    }
+    INSTRUMENT_SCOPE(STAGE_BEYOND_WINDOW);
+    if (compute_demand_utilization(taskset) > 1.0) {
+        result.verdict = ANALYSIS_OVERLOADED;
+        result.failing_td = TimeTraits<Time>::never();
+        return false;
+    }
+    bool clamped = false;
+    Time testing_bound = compute_testing_bound(taskset, bound, &clamped);
+    if (clamped) {
+        // A check up to the horizon would not cover the whole interval, so the set is not accepted
+        result.verdict = ANALYSIS_BOUND_BEYOND_HORIZON;
+        result.failing_td = TimeTraits<Time>::horizon();
+        return false;
+    }
+    if (bound == BOUND_QPA) {
+        Time failing_td = TimeTraits<Time>::zero();
+        if (!qpa_demand_test(taskset, window, testing_bound, &failing_td)) {
+            result.verdict = ANALYSIS_DEMAND_BEYOND_WINDOW;
+            result.failing_td = failing_td;
+            result.delta = failing_td - taskset_dbf(taskset, failing_td);
+            return false;
+        }
+        return true;
+    }
+
+    // Every deadline point up to the bound, a batch at a time: the bound can be billions of time units
+    std::vector<Time>& points = scratch.deadline_points;
+    std::vector<Time>& demand = scratch.point_demand;
+    start_deadline_points(taskset, window, testing_bound, scratch.heap);
+    bool more = true;
+    while (more) {
+        more = next_deadline_points(taskset, testing_bound, DEADLINE_POINT_BATCH, points, scratch.heap);
+        demand.resize(points.size());
+        taskset_dbf_points(taskset, points.data(), demand.data(), points.size());
+        INSTRUMENT_COUNT(COUNTER_DEADLINE_POINTS, points.size());
+        INSTRUMENT_COUNT(COUNTER_DBF_EVALUATIONS, points.size());
+        for (std::size_t k = 0; k < points.size(); k++) {
+            if (points[k] < demand[k]) {
+                result.verdict = ANALYSIS_DEMAND_BEYOND_WINDOW;
+                result.failing_td = points[k];
+                result.delta = points[k] - demand[k];
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,467 @@
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "multi_phase_corpus.h"
+
+static CorpusHeader make_header(uint64_t seed, uint64_t num_tasksets, uint64_t index_offset) {
+    CorpusHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC));
+    header.version = CORPUS_VERSION;
+    header.header_size = sizeof(CorpusHeader);
+    header.byte_order_mark = CORPUS_BYTE_ORDER_MARK;
+    header.record_size = sizeof(TaskRecord);
+    header.num_tasksets = num_tasksets;
+    header.index_offset = index_offset;
+    header.seed = seed;
+    return header;
+}
+
+TasksetWriter::~TasksetWriter() {
+    close();
+}
+
+bool TasksetWriter::open(const char* path, uint64_t seed) {
+    close();
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+    seed_ = seed;
+    failed_ = false;
+    offsets_.clear();
+
+    // Placeholder header: an unfinished file reads as "no index"
+    CorpusHeader header = make_header(seed_, 0, 0);
+    failed_ = std::fwrite(&header, sizeof(header), 1, file_) != 1;
+    position_ = sizeof(header);
+    return !failed_;
+}
+
+// The block is assembled in a reused buffer and written with a single fwrite
+
+bool TasksetWriter::write(const Tasks* tasks, std::size_t num_tasks) {
+
+    assert(file_ != nullptr);
+
+    std::size_t phase_doubles = 0;
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        if (!tasks[i].uniform_phases) {
+            phase_doubles += 2 * tasks[i].phases;
+        }
+    }
+    std::size_t records_end = sizeof(CorpusBlockHeader) + num_tasks * sizeof(TaskRecord);
+    std::size_t block_size = records_end + phase_doubles * sizeof(double);
+    block_.assign(block_size, 0);
+
+    CorpusBlockHeader block_header = {static_cast<uint32_t>(num_tasks), static_cast<uint32_t>(block_size)};
+    std::memcpy(block_.data(), &block_header, sizeof(block_header));
+
+    std::size_t phase_position = records_end;
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        const Tasks& task = tasks[i];
+        std::size_t record_position = sizeof(CorpusBlockHeader) + i * sizeof(TaskRecord);
+        TaskRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.period = task.period;
+        record.deadline = task.deadline;
+        record.wcet = task.wcet;
+        record.cleanup = task.cleanup;
+        record.utilization = task.utilization;
+        record.ptrust = task.ptrust;
+        record.id = task.id;
+        record.phases = static_cast<uint16_t>(task.phases);
+        record.flags = task.uniform_phases ? TASK_RECORD_UNIFORM_PHASES : 0;
+        if (!task.uniform_phases) {
+            record.phase_offset = static_cast<uint32_t>(phase_position - record_position);
+            for (int j = 0; j < task.phases; j++) {
+                double pair[2] = {task.phase_wcets[j], task.phase_cleanups[j]};
+                std::memcpy(block_.data() + phase_position, pair, sizeof(pair));
+                phase_position += sizeof(pair);
+            }
+        }
+        std::memcpy(block_.data() + record_position, &record, sizeof(record));
+    }
+
+    if (!failed_) {
+        failed_ = std::fwrite(block_.data(), block_size, 1, file_) != 1;
+    }
+    offsets_.push_back(position_);
+    position_ += block_size;
+    return !failed_;
+}
+
+bool TasksetWriter::close() {
+    if (file_ == nullptr) {
+        return !failed_;
+    }
+    uint64_t index_offset = position_;
+    if (!failed_ && !offsets_.empty()) {
+        failed_ = std::fwrite(offsets_.data(), sizeof(uint64_t), offsets_.size(), file_) != offsets_.size();
+    }
+    CorpusHeader header = make_header(seed_, offsets_.size(), offsets_.empty() ? 0 : index_offset);
+    if (!failed_) {
+        failed_ = std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, file_) != 1;
+    }
+    failed_ = (std::fclose(file_) != 0) || failed_;
+    file_ = nullptr;
+    return !failed_;
+}
+
+TasksetReader::~TasksetReader() {
+    close();
+}
+
+void TasksetReader::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<unsigned char*>(data_), length_);
+    }
+    data_ = nullptr;
+    length_ = 0;
+    header_ = nullptr;
+    offsets_ = nullptr;
+    num_tasksets_ = 0;
+    scanned_.clear();
+}
+
+// Whether a task can be analysed and simulated: every value finite, a positive period and deadline,
+// and no negative WCET or clean up cost (a zero period would never advance the release times)
+
+static bool valid_task_values(double period, double deadline, double wcet, double cleanup, double utilization, double ptrust) {
+    return std::isfinite(period) && std::isfinite(deadline) && std::isfinite(wcet) && std::isfinite(cleanup) &&
+           std::isfinite(utilization) && std::isfinite(ptrust) && period > 0.0 && deadline > 0.0 && wcet >= 0.0 &&
+           cleanup >= 0.0;
+}
+
+static bool valid_phase_values(const double* values, int count) {
+    for (int j = 0; j < count; j++) {
+        if (!std::isfinite(values[j]) || values[j] < 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether the block at 'offset' lies before 'end', its records and phase pairs lie inside it (so
+// that operator[] and the analysis never read outside the mapping or past MAX_PHASES), and every
+// task passes valid_task_values()
+
+static bool valid_block(const unsigned char* data, uint64_t offset, uint64_t end) {
+    if (offset % sizeof(uint64_t) != 0 || offset + sizeof(CorpusBlockHeader) > end) {
+        return false;
+    }
+    const CorpusBlockHeader* block = reinterpret_cast<const CorpusBlockHeader*>(data + offset);
+    uint64_t records_end = sizeof(CorpusBlockHeader) + uint64_t(block->num_tasks) * sizeof(TaskRecord);
+    if (block->block_size < records_end || block->block_size > end - offset) {
+        return false;
+    }
+    const TaskRecord* records = reinterpret_cast<const TaskRecord*>(data + offset + sizeof(CorpusBlockHeader));
+    for (uint32_t i = 0; i < block->num_tasks; i++) {
+        const TaskRecord& record = records[i];
+        if (record.phases < 1 || record.phases > MAX_PHASES ||
+            !valid_task_values(record.period, record.deadline, record.wcet, record.cleanup, record.utilization, record.ptrust)) {
+            return false;
+        }
+        if ((record.flags & TASK_RECORD_UNIFORM_PHASES) == 0) {
+            uint64_t pairs = sizeof(CorpusBlockHeader) + uint64_t(i) * sizeof(TaskRecord) + record.phase_offset;
+            if (record.phase_offset % sizeof(double) != 0 || pairs < records_end ||
+                pairs + uint64_t(record.phases) * 2 * sizeof(double) > block->block_size ||
+                !valid_phase_values(reinterpret_cast<const double*>(data + offset + pairs), 2 * record.phases)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool TasksetReader::open(const char* path, std::string* error) {
+
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        *error = std::string("cannot open '") + path + "'";
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(CorpusHeader))) {
+        ::close(fd);
+        *error = std::string("'") + path + "' is too short to be a task set corpus";
+        return false;
+    }
+    length_ = static_cast<std::size_t>(status.st_size);
+    void* mapping = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        length_ = 0;
+        *error = std::string("cannot map '") + path + "'";
+        return false;
+    }
+    data_ = static_cast<const unsigned char*>(mapping);
+    madvise(mapping, length_, MADV_SEQUENTIAL);
+
+    header_ = reinterpret_cast<const CorpusHeader*>(data_);
+    if (std::memcmp(header_->magic, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0) {
+        *error = std::string("'") + path + "' is not a task set corpus";
+    } else if (header_->byte_order_mark != CORPUS_BYTE_ORDER_MARK) {
+        *error = std::string("'") + path + "' was written on a machine with a different byte order";
+    } else if (header_->version != CORPUS_VERSION || header_->header_size != sizeof(CorpusHeader) ||
+               header_->record_size != sizeof(TaskRecord)) {
+        *error = std::string("'") + path + "' has unsupported corpus version " + std::to_string(header_->version);
+    } else if (header_->index_offset % sizeof(uint64_t) != 0) {
+        *error = std::string("'") + path + "' has a corrupt index";
+    } else {
+        error->clear();
+    }
+    if (!error->empty()) {
+        close();
+        return false;
+    }
+
+    // A file cut short (e.g. a partial copy) loses its index and is scanned like an unfinished one
+    bool has_index = header_->index_offset != 0 && header_->index_offset <= length_ &&
+                     header_->num_tasksets <= (length_ - header_->index_offset) / sizeof(uint64_t);
+    if (has_index) {
+        offsets_ = reinterpret_cast<const uint64_t*>(data_ + header_->index_offset);
+        num_tasksets_ = header_->num_tasksets;
+        for (std::size_t k = 0; k < num_tasksets_; k++) {
+            if (offsets_[k] < sizeof(CorpusHeader) || offsets_[k] > header_->index_offset) {
+                *error = std::string("'") + path + "' has a corrupt index";
+                close();
+                return false;
+            }
+            if (!valid_block(data_, offsets_[k], header_->index_offset)) {
+                *error = std::string("'") + path + "' has a corrupt task set " + std::to_string(k);
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Unfinished file: take every complete block up to the first truncated one
+    uint64_t position = sizeof(CorpusHeader);
+    uint64_t end = header_->index_offset != 0 ? std::min<uint64_t>(header_->index_offset, length_) : length_;
+    while (position + sizeof(CorpusBlockHeader) <= end) {
+        const CorpusBlockHeader* block = reinterpret_cast<const CorpusBlockHeader*>(data_ + position);
+        if (block->block_size < sizeof(CorpusBlockHeader) + uint64_t(block->num_tasks) * sizeof(TaskRecord) ||
+            position + block->block_size > end) {
+            break;
+        }
+        if (!valid_block(data_, position, end)) {
+            *error = std::string("'") + path + "' has a corrupt task set " + std::to_string(scanned_.size());
+            close();
+            return false;
+        }
+        scanned_.push_back(position);
+        position += block->block_size;
+    }
+    return true;
+}
+
+// Every block was checked by open(), so only the index needs to be in range
+
+TasksetView TasksetReader::operator[](std::size_t k) const {
+    assert(k < size());
+    uint64_t offset = offsets_ != nullptr ? offsets_[k] : scanned_[k];
+    const CorpusBlockHeader* block = reinterpret_cast<const CorpusBlockHeader*>(data_ + offset);
+    assert(offset + block->block_size <= length_);
+
+    TasksetView view;
+    view.tasks = reinterpret_cast<const TaskRecord*>(data_ + offset + sizeof(CorpusBlockHeader));
+    view.num_tasks = block->num_tasks;
+    return view;
+}
+
+Tasks task_from_record(const TaskRecord& record) {
+    Tasks task;
+    task.id = record.id;
+    task.period = record.period;
+    task.deadline = record.deadline;
+    task.wcet = record.wcet;
+    task.cleanup = record.cleanup;
+    task.utilization = record.utilization;
+    task.ptrust = record.ptrust;
+    task.phases = record.phases;
+    task.uniform_phases = (record.flags & TASK_RECORD_UNIFORM_PHASES) != 0;
+    if (!task.uniform_phases) {
+        for (int j = 0; j < task.phases && j < MAX_PHASES; j++) {
+            task.phase_wcets[j] = task_phase_wcet(record, j);
+            task.phase_cleanups[j] = task_phase_cleanup(record, j);
+        }
+    }
+    return task;
+}
+
+bool corpus_to_csv(const TasksetReader& reader, const char* csv_path, std::string* error) {
+
+    std::FILE* out = std::fopen(csv_path, "w");
+    if (out == nullptr) {
+        *error = std::string("cannot create '") + csv_path + "'";
+        return false;
+    }
+
+    std::fprintf(out, "taskset,id,period,deadline,wcet,cleanup,utilization,ptrust,phases,uniform_phases,phase_wcets,phase_cleanups\n");
+    for (std::size_t k = 0; k < reader.size(); k++) {
+        TasksetView view = reader[k];
+        for (std::size_t i = 0; i < view.num_tasks; i++) {
+            const TaskRecord& task = view.tasks[i];
+            bool uniform = (task.flags & TASK_RECORD_UNIFORM_PHASES) != 0;
+            std::fprintf(out, "%zu,%d,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%d,%d,", k, int(task.id), task.period, task.deadline,
+                         task.wcet, task.cleanup, task.utilization, task.ptrust, int(task.phases), uniform ? 1 : 0);
+            for (int j = 0; !uniform && j < task.phases; j++) {
+                std::fprintf(out, j == 0 ? "%.17g" : ";%.17g", task_phase_wcet(task, j));
+            }
+            std::fputc(',', out);
+            for (int j = 0; !uniform && j < task.phases; j++) {
+                std::fprintf(out, j == 0 ? "%.17g" : ";%.17g", task_phase_cleanup(task, j));
+            }
+            std::fputc('\n', out);
+        }
+    }
+
+    if (std::fclose(out) != 0) {
+        *error = std::string("cannot write '") + csv_path + "'";
+        return false;
+    }
+    return true;
+}
+
+// Splits one CSV line on ',' (the format has no quoting)
+
+static void split_fields(const std::string& line, char separator, std::vector<std::string>& fields) {
+    fields.clear();
+    std::size_t start = 0;
+    while (true) {
+        std::size_t end = line.find(separator, start);
+        fields.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+}
+
+// Whole-field number parsers: false if the field is empty or has anything after the number
+
+static bool parse_double(const std::string& text, double* value) {
+    char* end = nullptr;
+    *value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+static bool parse_integer(const std::string& text, long long* value) {
+    char* end = nullptr;
+    *value = std::strtoll(text.c_str(), &end, 10);
+    return !text.empty() && *end == '\0';
+}
+
+static bool parse_phase_list(const std::string& text, int phases, double* values) {
+    std::vector<std::string> items;
+    split_fields(text, ';', items);
+    if (static_cast<int>(items.size()) != phases) {
+        return false;
+    }
+    for (int j = 0; j < phases; j++) {
+        if (!parse_double(items[j], &values[j])) {
+            return false;
+        }
+    }
+    return valid_phase_values(values, phases);
+}
+
+bool csv_to_corpus(const char* csv_path, const char* corpus_path, std::string* error) {
+
+    std::FILE* in = std::fopen(csv_path, "r");
+    if (in == nullptr) {
+        *error = std::string("cannot open '") + csv_path + "'";
+        return false;
+    }
+    TasksetWriter writer;
+    if (!writer.open(corpus_path)) {
+        std::fclose(in);
+        *error = std::string("cannot create '") + corpus_path + "'";
+        return false;
+    }
+
+    std::vector<Tasks> taskset;
+    std::vector<std::string> fields;
+    std::string line;
+    long long current = -1;
+    long long line_number = 0;
+    bool ok = true;
+    bool written = true;
+    char buffer[4096];
+
+    while (ok && std::fgets(buffer, sizeof(buffer), in) != nullptr) {
+        line = buffer;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+            line.pop_back();
+        }
+        if (++line_number == 1 || line.empty()) {
+            continue; // Header row
+        }
+        split_fields(line, ',', fields);
+        if (fields.size() != 12) {
+            ok = false;
+            break;
+        }
+
+        long long index = 0;
+        long long id = 0;
+        long long phases = 0;
+        Tasks task;
+        ok = parse_integer(fields[0], &index) && parse_integer(fields[1], &id) && parse_double(fields[2], &task.period) &&
+             parse_double(fields[3], &task.deadline) && parse_double(fields[4], &task.wcet) &&
+             parse_double(fields[5], &task.cleanup) && parse_double(fields[6], &task.utilization) &&
+             parse_double(fields[7], &task.ptrust) && parse_integer(fields[8], &phases) &&
+             (fields[9] == "0" || fields[9] == "1");
+        ok = ok && id >= INT32_MIN && id <= INT32_MAX && phases >= 1 && phases <= MAX_PHASES &&
+             valid_task_values(task.period, task.deadline, task.wcet, task.cleanup, task.utilization, task.ptrust);
+        task.id = int(id);
+        task.phases = int(phases);
+        task.uniform_phases = fields[9] == "1";
+        if (ok && !task.uniform_phases) {
+            ok = parse_phase_list(fields[10], task.phases, task.phase_wcets) &&
+                 parse_phase_list(fields[11], task.phases, task.phase_cleanups);
+        }
+
+        // Rows of one task set are consecutive; a new index closes the previous set
+        if (ok && index != current) {
+            if (!taskset.empty()) {
+                ok = written = writer.write(taskset);
+            }
+            taskset.clear();
+            current = index;
+        }
+        taskset.push_back(task);
+    }
+    if (ok && !taskset.empty()) {
+        ok = written = writer.write(taskset);
+    }
+    std::fclose(in);
+
+    if (!written) {
+        writer.close();
+        *error = std::string("cannot write '") + corpus_path + "'";
+        return false;
+    }
+    if (!ok) {
+        writer.close();
+        *error = std::string(csv_path) + ":" + std::to_string(line_number) + ": malformed or out-of-range task row";
+        return false;
+    }
+    if (!writer.close()) {
+        *error = std::string("cannot write '") + corpus_path + "'";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,171 @@
+#ifndef MULTI_PHASE_CORPUS_H
+#define MULTI_PHASE_CORPUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "multi_phase_tasks.h"
+
+// Binary task set corpus (.mpts). All integers and doubles are stored in the byte order of the
+// writing machine, which the header records; a reader on the other byte order rejects the file.
+//
+//   CorpusHeader                                   64 bytes
+//   block 0 .. block n-1                           one per task set, 8-byte aligned
+//     CorpusBlockHeader                            8 bytes
+//     TaskRecord[num_tasks]                        64 bytes each
+//     phase table                                  (wcet, cleanup) doubles of every non-uniform task
+//   uint64_t block_offset[n]                       index, written when the file is closed
+//
+// Records are read in place from the mapped file: analyze_basic_taskset() and load_taskset()
+// accept TaskRecord directly, so replaying a corpus copies nothing.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+#define CORPUS_MAGIC "MPTASKS"
+#define CORPUS_VERSION 1
+#define CORPUS_BYTE_ORDER_MARK 0x01020304u
+
+// TaskRecord flags
+#define TASK_RECORD_UNIFORM_PHASES 0x1
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef struct CorpusHeader {
+    char magic[8];                  // CORPUS_MAGIC, NUL terminated
+    uint16_t version;               // CORPUS_VERSION
+    uint16_t header_size;           // sizeof(CorpusHeader)
+    uint32_t byte_order_mark;       // CORPUS_BYTE_ORDER_MARK as written by the producer
+    uint32_t record_size;           // sizeof(TaskRecord)
+    uint32_t reserved0;
+    uint64_t num_tasksets;          // 0 if the writer did not finish; blocks can still be scanned
+    uint64_t index_offset;          // File offset of the block index, 0 if there is none
+    uint64_t seed;                  // Master seed the corpus was generated from (informational)
+    uint64_t reserved1[2];
+} CorpusHeader;
+
+typedef struct CorpusBlockHeader {
+    uint32_t num_tasks;
+    uint32_t block_size;            // Bytes of the whole block including this header
+} CorpusBlockHeader;
+
+// One task as stored in a corpus
+typedef struct TaskRecord {
+    double period;
+    double deadline;
+    double wcet;
+    double cleanup;
+    double utilization;
+    double ptrust;
+    int32_t id;
+    uint16_t phases;
+    uint16_t flags;                 // TASK_RECORD_UNIFORM_PHASES
+    uint32_t phase_offset;          // Non-uniform phases: byte offset from this record to its (wcet, cleanup) pairs
+    uint32_t reserved;
+} TaskRecord;
+
+static_assert(sizeof(CorpusHeader) == 64, "corpus header layout");
+static_assert(sizeof(TaskRecord) == 64, "task record layout");
+
+// Task set stored in a corpus; 'tasks' points into the mapped file
+typedef struct TasksetView {
+    const TaskRecord* tasks = nullptr;
+    std::size_t num_tasks = 0;
+} TasksetView;
+
+// Appends task sets to a corpus file as they are produced. Blocks go through a stdio buffer; only the
+// block offsets (8 bytes per task set) are kept in memory until close() writes the index.
+class TasksetWriter {
+public:
+    TasksetWriter() = default;
+    ~TasksetWriter();
+    TasksetWriter(const TasksetWriter&) = delete;
+    TasksetWriter& operator=(const TasksetWriter&) = delete;
+
+    bool open(const char* path, uint64_t seed = 0);
+    bool write(const Tasks* tasks, std::size_t num_tasks);
+    bool write(const std::vector<Tasks>& tasks) { return write(tasks.data(), tasks.size()); }
+
+    // Writes the index and the final header; false if any write failed
+    bool close();
+
+    long long count() const { return static_cast<long long>(offsets_.size()); }
+
+private:
+    std::FILE* file_ = nullptr;
+    uint64_t seed_ = 0;
+    uint64_t position_ = 0;
+    bool failed_ = false;
+    std::vector<uint64_t> offsets_;
+    std::vector<unsigned char> block_;
+};
+
+// Read-only memory mapping of a corpus. Task sets are addressed through the index, or, for files
+// whose writer did not finish, through a sequential scan done once at open().
+class TasksetReader {
+public:
+    TasksetReader() = default;
+    ~TasksetReader();
+    TasksetReader(const TasksetReader&) = delete;
+    TasksetReader& operator=(const TasksetReader&) = delete;
+
+    // False with a description in *error if the file is missing or not a valid corpus. Every block
+    // header and record is checked here (one pass over the file), so views never leave the mapping,
+    // phase counts never exceed MAX_PHASES and every task has finite values, a positive period and
+    // deadline, and non-negative WCET and clean up costs.
+    bool open(const char* path, std::string* error);
+    void close();
+
+    std::size_t size() const { return offsets_ != nullptr ? num_tasksets_ : scanned_.size(); }
+    TasksetView operator[](std::size_t k) const;
+    uint64_t seed() const { return header_ != nullptr ? header_->seed : 0; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    std::size_t length_ = 0;
+    const CorpusHeader* header_ = nullptr;
+    const uint64_t* offsets_ = nullptr;             // Index inside the mapping
+    std::size_t num_tasksets_ = 0;
+    std::vector<uint64_t> scanned_;                 // Block offsets of an unfinished file
+};
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Copies a record into a Tasks (for code that needs the task structure itself)
+Tasks task_from_record(const TaskRecord& record);
+
+// CSV interchange: one row per task, "taskset,id,period,deadline,wcet,cleanup,utilization,ptrust,
+// phases,uniform_phases,phase_wcets,phase_cleanups" with the phase lists separated by ';'.
+// Doubles are printed with 17 significant digits so a round trip is exact. The import rejects rows
+// that TasksetReader::open() would reject, and fields with trailing characters.
+bool corpus_to_csv(const TasksetReader& reader, const char* csv_path, std::string* error);
+bool csv_to_corpus(const char* csv_path, const char* corpus_path, std::string* error);
+
+// =====================
+// FUNCTION DEFINITIONS
+// =====================
+
+// Phase accessors used by the analysis core for records read in place
+
+inline double task_phase_wcet(const TaskRecord& task, int j) {
+    if (task.flags & TASK_RECORD_UNIFORM_PHASES) {
+        return task.wcet;
+    }
+    return reinterpret_cast<const double*>(reinterpret_cast<const unsigned char*>(&task) + task.phase_offset)[2 * j];
+}
+
+inline double task_phase_cleanup(const TaskRecord& task, int j) {
+    if (task.flags & TASK_RECORD_UNIFORM_PHASES) {
+        return task.cleanup;
+    }
+    return reinterpret_cast<const double*>(reinterpret_cast<const unsigned char*>(&task) + task.phase_offset)[2 * j + 1];
+}
+
+#endif
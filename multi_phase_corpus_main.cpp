@@ -0,0 +1,259 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include "multi-phase.h"
+#include "multi_phase_experiment.h"
+#include "multi_phase_table.h"
+#include "multi_phase_cosched.h"
+#include "work_stealing.h"
+using namespace std;
+
+// Generates every task set of an experiment grid into one corpus, in grid order
+
+static int generate_corpus(const char* path, const ExperimentConfig& config) {
+
+    TasksetWriter writer;
+    if (!writer.open(path, config.seed)) {
+        cerr << "cannot create '" << path << "'\n";
+        return 1;
+    }
+
+    GeneratorContext ctx(config.seed, 0, SWEEP_RNG_ENGINE);
+    GeneratorParams params = config.base;
+    vector<Tasks> tasks;
+    UtilizationSampler sampler;
+    bool ok = true;
+    for (int num_tasks : config.task_counts) {
+        for (int num_phases : config.phase_counts) {
+            for (double trust_probability : config.trust_probabilities) {
+                for (double utilization : config.utilizations) {
+                    params.num_tasks = num_tasks;
+                    params.num_phases = num_phases;
+                    params.trust_probability = trust_probability;
+                    params.max_utilization = utilization;
+                    for (long long k = 0; ok && k < config.tasksets_per_point; k++) {
+                        ctx.seed(config.seed, k); // Same streams as the sweep of this grid point
+                        generate_tasks(ctx, params, sampler, tasks);
+                        ok = writer.write(tasks);
+                    }
+                }
+            }
+        }
+    }
+
+    long long written = writer.count();
+    if (!writer.close() || !ok) {
+        cerr << "cannot write '" << path << "'\n";
+        return 1;
+    }
+    cout << "Wrote " << written << " task sets to " << path << endl;
+    return 0;
+}
+
+// Replays a corpus through the analysis on all cores; the records are analysed in place
+
+static int replay_corpus(const char* path, TestingBound bound, int num_threads) {
+
+    TasksetReader reader;
+    string error;
+    if (!reader.open(path, &error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+
+    int num_workers = resolve_num_threads(num_threads);
+    vector<SweepCounters> per_worker(num_workers);
+    vector<AnalysisScratch> scratch(num_workers);
+    parallel_for_each_index(static_cast<long long>(reader.size()), num_threads, [&](long long index, int worker) {
+        TasksetView view = reader[index];
+        if (analyze_taskset_tiered(view.tasks, view.num_tasks, bound, scratch[worker])) {
+            per_worker[worker].total_scheduled++;
+        } else {
+            per_worker[worker].total_non_scheduled++;
+        }
+        per_worker[worker].decided_by[scratch[worker].result.tier]++;
+    });
+
+    SweepCounters total;
+    for (const SweepCounters& counters : per_worker) {
+        add_sweep_counters(total, counters);
+    }
+    cout<<"Total scheduled are: "<<total.total_scheduled<<" Total non-scheduled are: "<<total.total_non_scheduled<<endl;
+    print_sweep_tiers(cout, total);
+    return 0;
+}
+
+// Synthesizes the dispatch table of one task set of a corpus
+
+static int synthesize_table(const char* corpus_path, long long index, const char* table_path, Ticks ticks_per_unit) {
+
+    TasksetReader reader;
+    string error;
+    if (!reader.open(corpus_path, &error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    if (index < 0 || index >= static_cast<long long>(reader.size())) {
+        cerr << "'" << corpus_path << "' has no task set " << index << "\n";
+        return 1;
+    }
+    TasksetView view = reader[index];
+    vector<Tasks> tasks;
+    for (size_t i = 0; i < view.num_tasks; i++) {
+        tasks.push_back(task_from_record(view.tasks[i]));
+    }
+
+    ScheduleTableStats stats;
+    if (!write_schedule_table(table_path, tasks, ticks_per_unit, DEFAULT_TESTING_BOUND, &error, &stats)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    cout << "Wrote " << stats.entries << " entries (" << stats.segments << " segments, " << stats.jobs << " jobs, "
+         << stats.preemptions << " preemptions) over a hyperperiod of " << stats.hyperperiod << " ticks to " << table_path << endl;
+    return 0;
+}
+
+// Prints what runs at each of the given ticks
+
+static int lookup_table(const char* table_path, int num_ticks, char* ticks[]) {
+
+    ScheduleTableReader reader;
+    string error;
+    if (!reader.open(table_path, &error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    for (int k = 0; k < num_ticks; k++) {
+        Ticks t = strtoll(ticks[k], nullptr, 0);
+        if (t < 0) {
+            cerr << "ticks must not be negative\n";
+            return 1;
+        }
+        TableSlot slot = reader.lookup(t);
+        cout << t << ": " << table_entry_kind_name(slot.kind);
+        if (slot.kind != TABLE_IDLE) {
+            cout << " task=" << slot.task << " id=" << reader.task(slot.task).id << " phase=" << slot.phase << " chunk=" << slot.chunk;
+        }
+        cout << " [" << slot.start << ", " << slot.end << ")\n";
+    }
+    return 0;
+}
+
+// Places one task set of a corpus onto cores, isolating trusted from untrusted tasks where it can
+
+static int co_schedule(const char* corpus_path, long long index, int num_cores) {
+
+    TasksetReader reader;
+    string error;
+    if (!reader.open(corpus_path, &error)) {
+        cerr << error << "\n";
+        return 1;
+    }
+    if (index < 0 || index >= static_cast<long long>(reader.size())) {
+        cerr << "'" << corpus_path << "' has no task set " << index << "\n";
+        return 1;
+    }
+    TasksetView view = reader[index];
+    vector<Tasks> tasks;
+    for (size_t i = 0; i < view.num_tasks; i++) {
+        tasks.push_back(task_from_record(view.tasks[i]));
+    }
+
+    CoScheduleResult result;
+    if (!co_schedule_tasks(tasks, num_cores, CoScheduleOptions(), &result)) {
+        cout << "No schedulable placement on " << num_cores << " cores (" << result.starts_tried << " starts)\n";
+        return 1;
+    }
+    // Tasks by index into the task set, 't' for trusted and 'u' for untrusted ones
+    for (int core = 0; core < num_cores; core++) {
+        string members;
+        bool mixed = false;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (result.core_of_task[i] == core) {
+                members += (members.empty() ? "" : ",") + to_string(i) + (task_is_trusted(tasks[i]) ? "t" : "u");
+                mixed = mixed || (!result.core_isolated[core] && task_is_trusted(tasks[i]));
+            }
+        }
+        cout << "core " << core << (mixed ? " mixed" : " isolated") << " U=" << result.core_utilization[core]
+             << " cleanup=" << result.core_cleanup[core] << " tasks=" << members << "\n";
+    }
+    cout << "Clean up utilization " << result.cleanup_utilization << " against " << result.reference_cleanup << " ("
+         << cosched_reference_name(result.reference) << "), saved " << result.cleanup_saved << " (start " << result.start
+         << ", " << result.moves << " moves)\n";
+    return 0;
+}
+
+static void usage(const char* program) {
+    cerr << "usage: " << program << " generate CORPUS [--config FILE] [--tasksets N] [--seed N] [experiment options]\n"
+         << "       " << program << " replay CORPUS [--bound qpa|la_lb|busy_period|max_deadline] [--threads N]\n"
+         << "       " << program << " to-csv CORPUS CSV\n"
+         << "       " << program << " from-csv CSV CORPUS\n"
+         << "       " << program << " table CORPUS INDEX TABLE [TICKS_PER_UNIT]\n"
+         << "       " << program << " lookup TABLE TICK...\n"
+         << "       " << program << " cosched CORPUS INDEX CORES\n";
+}
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    string command = argv[1];
+    string error;
+
+    if (command == "generate" || command == "replay") {
+        // Both take experiment options; replay only uses bound and threads
+        ExperimentConfig config;
+        if (!parse_experiment_args(argc - 2, argv + 2, config, &error)) {
+            cerr << argv[0] << ": " << error << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+        return command == "generate" ? generate_corpus(argv[2], config) : replay_corpus(argv[2], config.bound, config.threads);
+    }
+
+    if (command == "to-csv" && argc == 4) {
+        TasksetReader reader;
+        if (!reader.open(argv[2], &error) || !corpus_to_csv(reader, argv[3], &error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "from-csv" && argc == 4) {
+        if (!csv_to_corpus(argv[2], argv[3], &error)) {
+            cerr << error << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "table" && (argc == 5 || argc == 6)) {
+        Ticks ticks_per_unit = argc == 6 ? strtoll(argv[5], nullptr, 0) : TICKS_PER_UNIT;
+        if (ticks_per_unit <= 0) {
+            cerr << argv[0] << ": TICKS_PER_UNIT must be positive\n";
+            return 1;
+        }
+        return synthesize_table(argv[2], strtoll(argv[3], nullptr, 0), argv[4], ticks_per_unit);
+    }
+
+    if (command == "lookup" && argc >= 4) {
+        return lookup_table(argv[2], argc - 3, argv + 3);
+    }
+
+    if (command == "cosched" && argc == 5) {
+        int num_cores = atoi(argv[4]);
+        if (num_cores <= 0) {
+            cerr << argv[0] << ": CORES must be positive\n";
+            return 1;
+        }
+        return co_schedule(argv[2], strtoll(argv[3], nullptr, 0), num_cores);
+    }
+
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include "multi_phase_cosched.h"
+#include "multi_phase_incremental.h"
+#include "work_stealing.h"
+
+bool task_is_trusted(const Tasks& task) {
+    for (int j = 0; j < task.phases; j++) {
+        if (task_phase_cleanup(task, j) > 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Tasks task_without_cleanup(const Tasks& task) {
+    Tasks copy = task;
+    copy.cleanup = 0.0;
+    std::fill(copy.phase_cleanups, copy.phase_cleanups + MAX_PHASES, 0.0);
+    return copy;
+}
+
+double task_cleanup_utilization(const Tasks& task, double beta) {
+    double cleanup = 0.0;
+    for (int j = 0; j < task.phases; j++) {
+        double phase_cleanup = task_phase_cleanup(task, j);
+        if (phase_cleanup > 0.0) {
+            cleanup += compute_min_chunks(task_phase_wcet(task, j), phase_cleanup, beta) * phase_cleanup;
+        }
+    }
+    return cleanup / task.period;
+}
+
+// Tasks of one core and its admission state
+
+typedef struct CoreState {
+    IncrementalAnalyzer analyzer;
+    std::vector<int> members;       // Indices into the task set
+    int trusted = 0;
+    int untrusted = 0;
+    double utilization = 0.0;
+    double cleanup = 0.0;           // Clean up utilization; 0 while no untrusted task is on the core
+} CoreState;
+
+// One placement under construction; a task keeps its index as id on its core
+
+class CoScheduler {
+public:
+    CoScheduler(const std::vector<Tasks>& tasks, const std::vector<bool>& trusted, int num_cores, TestingBound bound)
+        : tasks_(tasks), trusted_(trusted), bound_(bound), core_of_(tasks.size(), -1) {
+        CoreState empty;
+        empty.analyzer = IncrementalAnalyzer(bound);
+        cores_.assign(num_cores, empty);
+    }
+
+    // Greedy placement: untrusted tasks first, on the cores from 'split' on if they fit there, then
+    // trusted tasks, on isolated cores if they fit there; within each group cores are tried by 'fit'
+    bool construct(int split, PartitionHeuristic heuristic);
+
+    // The given placement, task by task in index order
+    bool assign(const std::vector<int>& core_of_task);
+
+    // Local search until no move or swap lowers the clean up work; returns the moves made
+    long long improve(int max_rounds);
+
+    void fill(CoScheduleResult& result) const;
+
+private:
+    Tasks admitted_task(int i, bool isolated) const {
+        Tasks task = isolated && trusted_[i] ? task_without_cleanup(tasks_[i]) : tasks_[i];
+        task.id = i;
+        return task;
+    }
+
+    bool reanalyze(CoreState& core, bool isolated) const;
+    bool admit(CoreState& core, int i) const;
+    bool evict(CoreState& core, int i) const;
+    void refresh_cleanup(CoreState& core) const;
+    bool try_move(int i, int core);
+    bool try_swap(int i, int j);
+
+    const std::vector<Tasks>& tasks_;
+    const std::vector<bool>& trusted_;
+    TestingBound bound_;
+    std::vector<CoreState> cores_;
+    std::vector<int> core_of_;
+};
+
+// Analyses the members of a core from scratch, with or without the clean up of its trusted tasks
+
+bool CoScheduler::reanalyze(CoreState& core, bool isolated) const {
+    IncrementalAnalyzer analyzer(bound_);
+    for (int m : core.members) {
+        if (!analyzer.try_admit(admitted_task(m, isolated))) {
+            return false;
+        }
+    }
+    core.analyzer = std::move(analyzer);
+    return true;
+}
+
+bool CoScheduler::admit(CoreState& core, int i) const {
+    const Tasks& task = tasks_[i];
+    double util = task.wcet / task.period;
+    // As in partition_tasks(): demand utilization above 1 fails the test beyond the window
+    if (bound_ != BOUND_MAX_DEADLINE && core.utilization + util > 1.0) {
+        return false;
+    }
+    if (!trusted_[i] && core.untrusted == 0 && core.trusted > 0) {
+        // The first untrusted task ends the isolation: the trusted tasks get their clean up back
+        CoreState mixed = core;
+        if (!reanalyze(mixed, false) || !mixed.analyzer.try_admit(admitted_task(i, false))) {
+            return false;
+        }
+        core.analyzer = std::move(mixed.analyzer);
+    } else if (!core.analyzer.try_admit(admitted_task(i, core.untrusted == 0))) {
+        return false;
+    }
+    core.members.push_back(i);
+    core.trusted += trusted_[i];
+    core.untrusted += !trusted_[i];
+    core.utilization += util;
+    refresh_cleanup(core);
+    return true;
+}
+
+// False if the analyzer does not hold the task or the isolated core fails its re-analysis; the
+// core is then inconsistent, so callers work on a copy and drop it
+
+bool CoScheduler::evict(CoreState& core, int i) const {
+    if (!core.analyzer.remove(i)) {
+        return false;
+    }
+    core.members.erase(std::find(core.members.begin(), core.members.end(), i));
+    core.trusted -= trusted_[i];
+    core.untrusted -= !trusted_[i];
+    core.utilization -= tasks_[i].wcet / tasks_[i].period;
+    // Without its last untrusted task the core is isolated; dropping clean up only lowers beta_init
+    // to the largest phase WCET, which still exceeds the (now zero) clean up costs
+    if (!trusted_[i] && core.untrusted == 0 && core.trusted > 0 && !reanalyze(core, true)) {
+        return false;
+    }
+    refresh_cleanup(core);
+    return true;
+}
+
+void CoScheduler::refresh_cleanup(CoreState& core) const {
+    core.cleanup = 0.0;
+    if (core.untrusted == 0) {
+        return;
+    }
+    for (int m : core.members) {
+        if (trusted_[m]) {
+            core.cleanup += task_cleanup_utilization(tasks_[m], core.analyzer.beta(m));
+        }
+    }
+}
+
+bool CoScheduler::construct(int split, PartitionHeuristic heuristic) {
+
+    const int n = static_cast<int>(tasks_.size());
+    const int num_cores = static_cast<int>(cores_.size());
+    std::vector<double> keys(n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = partition_key(tasks_[i], heuristic.order);
+    }
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return trusted_[a] != trusted_[b] ? trusted_[b] : keys[a] > keys[b];
+    });
+
+    std::vector<int> candidates(num_cores);
+    for (int i : order) {
+        std::iota(candidates.begin(), candidates.end(), 0);
+        if (heuristic.fit == PARTITION_BEST_FIT) {
+            std::stable_sort(candidates.begin(), candidates.end(), [this](int a, int b) { return cores_[a].utilization > cores_[b].utilization; });
+        } else if (heuristic.fit == PARTITION_WORST_FIT) {
+            std::stable_sort(candidates.begin(), candidates.end(), [this](int a, int b) { return cores_[a].utilization < cores_[b].utilization; });
+        }
+        std::stable_partition(candidates.begin(), candidates.end(), [&](int core) {
+            return trusted_[i] ? cores_[core].untrusted == 0 : core >= split;
+        });
+
+        bool empty_rejected = false;
+        for (int core : candidates) {
+            bool empty = cores_[core].members.empty();
+            if (empty && empty_rejected) {
+                continue; // All empty cores decide alike
+            }
+            if (admit(cores_[core], i)) {
+                core_of_[i] = core;
+                break;
+            }
+            empty_rejected = empty_rejected || empty;
+        }
+        if (core_of_[i] < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CoScheduler::assign(const std::vector<int>& core_of_task) {
+    for (std::size_t i = 0; i < core_of_task.size(); i++) {
+        if (!admit(cores_[core_of_task[i]], static_cast<int>(i))) {
+            return false;
+        }
+        core_of_[i] = core_of_task[i];
+    }
+    return true;
+}
+
+// Moves and swaps are evaluated on copies of the two cores involved and kept if both stay
+// schedulable and their clean up work drops
+
+bool CoScheduler::try_move(int i, int core) {
+    int from = core_of_[i];
+    CoreState source = cores_[from];
+    CoreState target = cores_[core];
+    if (!evict(source, i) || !admit(target, i)) {
+        return false;
+    }
+    if (!(source.cleanup + target.cleanup < cores_[from].cleanup + cores_[core].cleanup - COSCHED_EPSILON)) {
+        return false;
+    }
+    cores_[from] = std::move(source);
+    cores_[core] = std::move(target);
+    core_of_[i] = core;
+    return true;
+}
+
+bool CoScheduler::try_swap(int i, int j) {
+    int a = core_of_[i];
+    int b = core_of_[j];
+    CoreState core_a = cores_[a];
+    CoreState core_b = cores_[b];
+    if (!evict(core_a, i) || !evict(core_b, j) || !admit(core_a, j) || !admit(core_b, i)) {
+        return false;
+    }
+    if (!(core_a.cleanup + core_b.cleanup < cores_[a].cleanup + cores_[b].cleanup - COSCHED_EPSILON)) {
+        return false;
+    }
+    cores_[a] = std::move(core_a);
+    cores_[b] = std::move(core_b);
+    std::swap(core_of_[i], core_of_[j]);
+    return true;
+}
+
+long long CoScheduler::improve(int max_rounds) {
+
+    const int n = static_cast<int>(tasks_.size());
+    const int num_cores = static_cast<int>(cores_.size());
+    long long moves = 0;
+    for (int round = 0; round < max_rounds; round++) {
+        bool improved = false;
+        // Only tasks on cores that pay clean up can lower it by leaving
+        for (int i = 0; i < n; i++) {
+            for (int core = 0; core < num_cores && cores_[core_of_[i]].cleanup > 0.0; core++) {
+                if (core != core_of_[i] && try_move(i, core)) {
+                    improved = true;
+                    moves++;
+                }
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n && cores_[core_of_[i]].cleanup > 0.0; j++) {
+                if (trusted_[i] != trusted_[j] && core_of_[i] != core_of_[j] && try_swap(i, j)) {
+                    improved = true;
+                    moves++;
+                }
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+    return moves;
+}
+
+void CoScheduler::fill(CoScheduleResult& result) const {
+    result.core_of_task = core_of_;
+    result.core_isolated.assign(cores_.size(), false);
+    result.core_utilization.assign(cores_.size(), 0.0);
+    result.core_cleanup.assign(cores_.size(), 0.0);
+    result.cleanup_utilization = 0.0;
+    for (std::size_t core = 0; core < cores_.size(); core++) {
+        result.core_isolated[core] = cores_[core].untrusted == 0;
+        result.core_utilization[core] = cores_[core].utilization;
+        result.core_cleanup[core] = cores_[core].cleanup;
+        result.cleanup_utilization += cores_[core].cleanup;
+    }
+}
+
+// Clean up utilization of 'tasks' on one core with every clean up paid; false if not schedulable
+
+static bool core_cleanup_utilization(const std::vector<Tasks>& tasks, TestingBound bound, AnalysisScratch& scratch, double* cleanup) {
+    if (!analyze_taskset(tasks.data(), tasks.size(), bound, scratch)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        if (task_is_trusted(tasks[i])) {
+            *cleanup += task_cleanup_utilization(tasks[i], scratch.beta_per_task[i]);
+        }
+    }
+    return true;
+}
+
+bool co_schedule_tasks(const std::vector<Tasks>& tasks, int num_cores, const CoScheduleOptions& options, CoScheduleResult* result) {
+
+    std::vector<PartitionHeuristic> heuristics = options.heuristics.empty() ? partition_heuristics() : options.heuristics;
+    const int num_heuristics = static_cast<int>(heuristics.size());
+    const int num_greedy = (num_cores + 1) * num_heuristics;
+    std::vector<bool> trusted(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        trusted[i] = task_is_trusted(tasks[i]);
+    }
+
+    // Reference without isolation: one core if it suffices, else the security-oblivious partition
+    CoScheduleReference reference = COSCHED_REFERENCE_NONE;
+    double reference_cleanup = 0.0;
+    std::vector<int> reference_placement;
+    AnalysisScratch scratch;
+    if (core_cleanup_utilization(tasks, options.bound, scratch, &reference_cleanup)) {
+        reference = COSCHED_REFERENCE_SINGLE_CORE;
+        reference_placement.assign(tasks.size(), 0);
+    } else {
+        PartitionOptions partition_options;
+        partition_options.heuristics = heuristics;
+        partition_options.bound = options.bound;
+        partition_options.threads = options.threads;
+        PartitionResult partition;
+        reference_cleanup = 0.0;
+        if (partition_tasks(tasks, num_cores, partition_options, &partition)) {
+            reference = COSCHED_REFERENCE_PARTITION;
+            reference_placement = partition.core_of_task;
+            std::vector<std::vector<Tasks>> cores;
+            partition_cores(tasks, partition, cores);
+            for (const std::vector<Tasks>& core : cores) {
+                core_cleanup_utilization(core, options.bound, scratch, &reference_cleanup);
+            }
+        } else {
+            for (const Tasks& task : tasks) {
+                for (int j = 0; j < task.phases; j++) {
+                    reference_cleanup += task_phase_cleanup(task, j) / task.period;
+                }
+            }
+        }
+    }
+    const int count = num_greedy + (reference_placement.empty() ? 0 : 1);
+
+    // Rank of the first start that reached zero clean up; no later start can do better
+    std::atomic<int> optimal(count);
+    std::atomic<int> tried(0);
+    std::vector<CoScheduleResult> attempts(count);
+    parallel_for_each_index(count, options.threads, [&](long long index, int) {
+        int rank = static_cast<int>(index);
+        if (optimal.load(std::memory_order_relaxed) < rank) {
+            return;
+        }
+        tried.fetch_add(1, std::memory_order_relaxed);
+        CoScheduler scheduler(tasks, trusted, num_cores, options.bound);
+        CoScheduleResult& attempt = attempts[rank];
+        attempt.start = rank;
+        bool placed = rank < num_greedy ? scheduler.construct(rank / num_heuristics, heuristics[rank % num_heuristics])
+                                        : scheduler.assign(reference_placement);
+        if (!placed) {
+            return;
+        }
+        attempt.moves = scheduler.improve(options.max_rounds);
+        scheduler.fill(attempt);
+        attempt.feasible = true;
+        if (attempt.cleanup_utilization <= 0.0) {
+            int best = optimal.load(std::memory_order_relaxed);
+            while (rank < best && !optimal.compare_exchange_weak(best, rank, std::memory_order_relaxed)) {
+            }
+        }
+    });
+
+    int best = -1;
+    for (int rank = 0; rank < count; rank++) {
+        if (attempts[rank].feasible && (best < 0 || attempts[rank].cleanup_utilization < attempts[best].cleanup_utilization)) {
+            best = rank;
+        }
+    }
+    if (result != nullptr) {
+        *result = best >= 0 ? attempts[best] : CoScheduleResult();
+        result->starts_tried = tried.load();
+        result->reference = reference;
+        result->reference_cleanup = reference_cleanup;
+        result->cleanup_saved = best >= 0 ? reference_cleanup - result->cleanup_utilization : 0.0;
+    }
+    return best >= 0;
+}
+
+void co_schedule_cores(const std::vector<Tasks>& tasks, const CoScheduleResult& result, std::vector<std::vector<Tasks>>& cores) {
+    cores.assign(result.core_isolated.size(), std::vector<Tasks>());
+    for (std::size_t i = 0; i < tasks.size() && i < result.core_of_task.size(); i++) {
+        int core = result.core_of_task[i];
+        if (core >= 0) {
+            cores[core].push_back(result.core_isolated[core] ? task_without_cleanup(tasks[i]) : tasks[i]);
+        }
+    }
+}
+
+const char* cosched_reference_name(CoScheduleReference reference) {
+    switch (reference) {
+        case COSCHED_REFERENCE_SINGLE_CORE:
+            return "single_core";
+        case COSCHED_REFERENCE_PARTITION:
+            return "partition";
+        case COSCHED_REFERENCE_NONE:
+            return "none";
+    }
+    return "unknown";
+}
@@ -0,0 +1,99 @@
+#ifndef MULTI_PHASE_COSCHED_H
+#define MULTI_PHASE_COSCHED_H
+
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_partition.h"
+
+// Security-aware partitioning on m identical cores. A trusted task (one with a clean up cost, i.e. a
+// potential victim) only has to clean up because an untrusted task may run on its core after it; on
+// a core that holds no untrusted task its phases run without clean up. The placement therefore
+// decides both schedulability and the clean up work: every core is checked with the multi-phase test
+// on its own tasks, with the clean up costs of trusted tasks dropped on isolated cores.
+//
+// The clean up work of a placement is its clean up utilization, sum(k_ij * c_ij / T_i) over the
+// phases of the trusted tasks on mixed cores, where k_ij is the chunk count of phase j at the beta
+// of task i on its core: each chunk may end in a preemption and so in a clean up. It is compared
+// with the clean up utilization of the same tasks without isolation: on a single core if they are
+// schedulable there, otherwise as partition_tasks() places them.
+//
+// The search starts from greedy placements, one per heuristic of the partitioner and per number of
+// cores set aside for trusted tasks, and from the reference placement itself, so it never does worse
+// than the reference. Each start is improved by local search: moving a task to another core and
+// swapping a trusted with an untrusted task, both kept only if every core stays schedulable and the
+// clean up work drops. Each core keeps an IncrementalAnalyzer, so a move re-analyzes only the two
+// cores involved. Starts run in parallel; the best placement (lowest start index among equals) does
+// not depend on the number of threads.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Number of worker threads that run starts (0 = one per hardware thread)
+#define COSCHED_THREADS 0
+
+// Most improvement rounds of the local search per start
+#define COSCHED_MAX_ROUNDS 32
+
+// Least decrease of the clean up utilization a move has to achieve
+#define COSCHED_EPSILON 1e-12
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Placement without isolation the clean up work is compared with
+typedef enum {
+    COSCHED_REFERENCE_SINGLE_CORE,  // All tasks on one core
+    COSCHED_REFERENCE_PARTITION,    // The partition_tasks() placement, every clean up paid
+    COSCHED_REFERENCE_NONE          // Neither is schedulable: one clean up per phase and job, a lower bound
+} CoScheduleReference;
+
+typedef struct CoScheduleOptions {
+    std::vector<PartitionHeuristic> heuristics;     // Greedy orders and fits; empty = partition_heuristics()
+    TestingBound bound = DEFAULT_TESTING_BOUND;     // Bound of the per-core test
+    int max_rounds = COSCHED_MAX_ROUNDS;
+    int threads = COSCHED_THREADS;
+} CoScheduleOptions;
+
+typedef struct CoScheduleResult {
+    bool feasible = false;
+    std::vector<int> core_of_task;                  // Core of tasks[i] (empty if infeasible)
+    std::vector<bool> core_isolated;                // No untrusted task on the core, so no clean up on it
+    std::vector<double> core_utilization;           // sum(Ci / Ti) of every core
+    std::vector<double> core_cleanup;               // Clean up utilization of every core
+    double cleanup_utilization = 0.0;               // Of the whole placement
+    CoScheduleReference reference = COSCHED_REFERENCE_NONE;
+    double reference_cleanup = 0.0;                 // Clean up utilization of the reference placement
+    double cleanup_saved = 0.0;                     // reference_cleanup - cleanup_utilization
+    int start = -1;                                 // Start the placement comes from: split * heuristics + heuristic,
+                                                    // then the reference placement
+    int starts_tried = 0;                           // Starts that ran (starts after one without clean up are skipped)
+    long long moves = 0;                            // Improving moves made from the chosen start
+} CoScheduleResult;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// A task is trusted if any of its phases has a clean up cost
+bool task_is_trusted(const Tasks& task);
+
+// Copy of a task without clean up, as it runs on an isolated core
+Tasks task_without_cleanup(const Tasks& task);
+
+// Clean up utilization of a task at the given beta: sum over phases of k_j * c_j / T
+double task_cleanup_utilization(const Tasks& task, double beta);
+
+// Places 'tasks' onto num_cores cores so that every core is schedulable and the clean up work is as
+// small as the search finds; false if no start finds a schedulable placement
+bool co_schedule_tasks(const std::vector<Tasks>& tasks, int num_cores, const CoScheduleOptions& options = CoScheduleOptions(),
+                       CoScheduleResult* result = nullptr);
+
+// Name of a reference placement, e.g. "single_core"
+const char* cosched_reference_name(CoScheduleReference reference);
+
+// Task set of every core as it is analysed: tasks in task order, without clean up on isolated cores
+void co_schedule_cores(const std::vector<Tasks>& tasks, const CoScheduleResult& result, std::vector<std::vector<Tasks>>& cores);
+
+#endif
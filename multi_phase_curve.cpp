@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include "multi_phase_curve.h"
+
+void wilson_interval(long long accepted, long long tasksets, double z, double* low, double* high) {
+
+    if (tasksets <= 0) {
+        *low = 0.0;
+        *high = 1.0;
+        return;
+    }
+    double n = double(tasksets);
+    double p = accepted / n;
+    double z2 = z * z;
+    double denominator = 1.0 + z2 / n;
+    double center = (p + z2 / (2.0 * n)) / denominator;
+    double half_width = z / denominator * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+    *low = accepted == 0 ? 0.0 : std::max(center - half_width, 0.0);
+    *high = accepted == tasksets ? 1.0 : std::min(center + half_width, 1.0);
+}
+
+double confidence_quantile(double confidence) {
+    // P(|Z| > z) = erfc(z / sqrt(2)) falls monotonically in z; bisect for 1 - confidence
+    double low = 0.0, high = 10.0;
+    for (int k = 0; k < 64; k++) {
+        double mid = 0.5 * (low + high);
+        if (std::erfc(mid / std::sqrt(2.0)) > 1.0 - confidence) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return 0.5 * (low + high);
+}
+
+CurvePoint sample_curve_point(const GeneratorParams& params, const CurveOptions& options, uint64_t master_seed,
+                              int num_threads, TestingBound bound, const ReportOptions& report_options) {
+
+    CurvePoint point;
+    point.utilization = params.max_utilization;
+    point.report.options = report_options;
+    ResultReport* report = report_options.format != REPORT_NONE ? &point.report : nullptr;
+    double z = confidence_quantile(options.confidence);
+
+    while (point.tasksets < options.max_tasksets) {
+        long long count = std::min(options.batch, options.max_tasksets - point.tasksets);
+        SweepCounters batch = run_taskset_sweep_range(params, point.tasksets, count, master_seed, num_threads, bound, report);
+        add_sweep_counters(point.counters, batch);
+        point.tasksets += count;
+        wilson_interval(point.counters.total_scheduled, point.tasksets, z, &point.ci_low, &point.ci_high);
+        if (0.5 * (point.ci_high - point.ci_low) <= options.ci_half_width) {
+            break;
+        }
+    }
+    point.ratio = double(point.counters.total_scheduled) / point.tasksets;
+    return point;
+}
+
+// Fills the points strictly between the sampled points lo and hi
+
+static void fill_between(std::vector<CurvePoint>& points, std::size_t lo, std::size_t hi, const GeneratorParams& params,
+                         const CurveOptions& options, uint64_t master_seed, int num_threads, TestingBound bound,
+                         const ReportOptions& report_options) {
+
+    if (hi - lo <= 1) {
+        return;
+    }
+    const CurvePoint& left = points[lo];
+    const CurvePoint& right = points[hi];
+    bool all_accepted = left.counters.total_non_scheduled == 0 && right.counters.total_non_scheduled == 0;
+    bool none_accepted = left.counters.total_scheduled == 0 && right.counters.total_scheduled == 0;
+
+    if (options.skip_saturated && (all_accepted || none_accepted)) {
+        for (std::size_t k = lo + 1; k < hi; k++) {
+            points[k].inferred = true;
+            points[k].ratio = all_accepted ? 1.0 : 0.0;
+            points[k].ci_low = all_accepted ? right.ci_low : 0.0;
+            points[k].ci_high = all_accepted ? 1.0 : left.ci_high;
+        }
+        return;
+    }
+
+    std::size_t mid = lo + (hi - lo) / 2;
+    GeneratorParams point_params = params;
+    point_params.max_utilization = points[mid].utilization;
+    points[mid] = sample_curve_point(point_params, options, master_seed, num_threads, bound, report_options);
+    fill_between(points, lo, mid, params, options, master_seed, num_threads, bound, report_options);
+    fill_between(points, mid, hi, params, options, master_seed, num_threads, bound, report_options);
+}
+
+std::vector<CurvePoint> run_acceptance_curve(const GeneratorParams& params, std::vector<double> utilizations,
+                                             const CurveOptions& options, uint64_t master_seed, int num_threads,
+                                             TestingBound bound, const ReportOptions& report_options) {
+
+    std::sort(utilizations.begin(), utilizations.end());
+    std::vector<CurvePoint> points(utilizations.size());
+    for (std::size_t k = 0; k < utilizations.size(); k++) {
+        points[k].utilization = utilizations[k];
+    }
+    if (points.empty()) {
+        return points;
+    }
+
+    // Both ends are always sampled; the interior is bisected so saturated stretches are skipped whole
+    GeneratorParams point_params = params;
+    for (std::size_t k = 0; k < points.size(); k += std::max<std::size_t>(points.size() - 1, 1)) {
+        point_params.max_utilization = points[k].utilization;
+        points[k] = sample_curve_point(point_params, options, master_seed, num_threads, bound, report_options);
+    }
+    fill_between(points, 0, points.size() - 1, params, options, master_seed, num_threads, bound, report_options);
+    return points;
+}
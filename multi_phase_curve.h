@@ -0,0 +1,78 @@
+#ifndef MULTI_PHASE_CURVE_H
+#define MULTI_PHASE_CURVE_H
+
+#include <cstdint>
+#include <vector>
+#include "multi_phase_generator.h"
+#include "multi_phase_bound.h"
+#include "multi_phase_sweep.h"
+#include "multi_phase_report.h"
+
+// Acceptance-ratio curves over utilization. Every point is sampled in batches until the Wilson
+// score interval of its acceptance ratio is narrow enough, and points enclosed by two sampled points
+// that are both at 0% or both at 100% are not sampled at all but inferred from them. The curve is
+// not monotone in general (clean up costs reject many low-utilization task sets), so the inference
+// assumes only that it does not dip or peak between two saturated points.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Target half-width of the confidence interval of every sampled point
+#define CURVE_CI_HALF_WIDTH 0.02
+
+// Confidence level of the interval
+#define CURVE_CONFIDENCE 0.95
+
+// Task sets generated per batch, and the least a point is sampled with before it may stop
+#define CURVE_BATCH 256
+
+// Most task sets generated for one point, even if its interval is still wider than the target
+#define CURVE_MAX_TASKSETS 100000
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef struct CurveOptions {
+    double ci_half_width = CURVE_CI_HALF_WIDTH;
+    double confidence = CURVE_CONFIDENCE;
+    long long batch = CURVE_BATCH;
+    long long max_tasksets = CURVE_MAX_TASKSETS;
+    bool skip_saturated = true;                     // Infer points between two points at 0% or at 100%
+} CurveOptions;
+
+typedef struct CurvePoint {
+    double utilization = 0.0;
+    SweepCounters counters;                         // Zero for an inferred point
+    long long tasksets = 0;
+    double ratio = 0.0;
+    double ci_low = 0.0;
+    double ci_high = 1.0;
+    bool inferred = false;                          // Not sampled; ratio and interval come from its neighbours
+    ResultReport report;                            // Filled only if a report format was requested
+} CurvePoint;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Wilson score interval of 'accepted' successes out of 'tasksets' at normal quantile z
+void wilson_interval(long long accepted, long long tasksets, double z, double* low, double* high);
+
+// Two-sided normal quantile of a confidence level, e.g. 1.96 for 0.95
+double confidence_quantile(double confidence);
+
+// Samples one point in batches of options.batch until the interval half-width reaches the target
+// or options.max_tasksets is reached. Batch k draws task sets [k * batch, (k + 1) * batch) of the
+// master seed, so the result does not depend on the number of threads.
+CurvePoint sample_curve_point(const GeneratorParams& params, const CurveOptions& options, uint64_t master_seed,
+                              int num_threads, TestingBound bound, const ReportOptions& report_options);
+
+// Curve over 'utilizations' (params.max_utilization is replaced by each of them); the points are
+// returned in ascending utilization order
+std::vector<CurvePoint> run_acceptance_curve(const GeneratorParams& params, std::vector<double> utilizations,
+                                             const CurveOptions& options, uint64_t master_seed, int num_threads,
+                                             TestingBound bound, const ReportOptions& report_options);
+
+#endif
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include "multi_phase_dbf_cache.h"
+#include "multi_phase_core.h"
+
+static uint64_t double_bits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+std::size_t DbfCache::DbfKeyHash::operator()(const DbfKey& key) const {
+    // splitmix64 finalizer over the combined bit patterns
+    uint64_t h = key.period * 0x9e3779b97f4a7c15ULL ^ (key.deadline + 0x632be59bd9b4e019ULL) * 0xbf58476d1ce4e5b9ULL ^ key.wcet;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return std::size_t(h ^ (h >> 31));
+}
+
+void build_dbf_curve(const Tasks& task, double horizon, DbfCurve& curve) {
+    typedef TimeTraits<double> Traits;
+    curve.period = task.period;
+    curve.deadline = task.deadline;
+    curve.wcet = task.wcet;
+    curve.horizon = std::min(horizon, Traits::horizon());
+    curve.points.clear();
+    curve.demand.clear();
+    // Same points as enumerate_deadline_points(); jobs that round to the same point merge into one breakpoint
+    for (long long job = 0;; job++) {
+        double point = std::max(Traits::grid_ceil(Traits::scale(job, task.period) + task.deadline), Traits::unit());
+        if (point > curve.horizon) {
+            break;
+        }
+        if (!curve.points.empty() && curve.points.back() == point) {
+            curve.demand.back() = double(job + 1) * task.wcet;
+        } else {
+            curve.points.push_back(point);
+            curve.demand.push_back(double(job + 1) * task.wcet);
+        }
+    }
+}
+
+double dbf_curve_at(const DbfCurve& curve, double t) {
+    assert(t <= curve.horizon);
+    std::size_t k = std::upper_bound(curve.points.begin(), curve.points.end(), t) - curve.points.begin();
+    if (k == 0) {
+        return 0.0;
+    }
+    return curve.demand[k - 1];
+}
+
+std::shared_ptr<const DbfCurve> DbfCache::lookup(const Tasks& task, double horizon) {
+
+    DbfKey key = {double_bits(task.period), double_bits(task.deadline), double_bits(task.wcet)};
+    auto found = entries_.find(key);
+    if (found != entries_.end() && found->second.curve->horizon >= std::min(horizon, TimeTraits<double>::horizon())) {
+        stats_.hits++;
+        recency_.splice(recency_.begin(), recency_, found->second.use);
+        return found->second.curve;
+    }
+
+    stats_.misses++;
+    std::shared_ptr<DbfCurve> curve = std::make_shared<DbfCurve>();
+    build_dbf_curve(task, found != entries_.end() ? std::max(horizon, 2.0 * found->second.curve->horizon) : horizon, *curve);
+    std::size_t bytes = sizeof(DbfCurve) + (curve->points.capacity() + curve->demand.capacity()) * sizeof(double);
+    if (found != entries_.end()) {
+        stats_.bytes -= found->second.bytes;
+        recency_.splice(recency_.begin(), recency_, found->second.use);
+        found->second.curve = curve;
+        found->second.bytes = bytes;
+    } else {
+        recency_.push_front(key);
+        entries_.emplace(key, DbfEntry{curve, recency_.begin(), bytes});
+    }
+    stats_.bytes += bytes;
+    evict_to_budget(key);
+    stats_.entries = entries_.size();
+    return curve;
+}
+
+// Drops least recently used curves until the budget holds, but never 'keep' (the curve just looked up)
+
+void DbfCache::evict_to_budget(const DbfKey& keep) {
+    while (stats_.bytes > budget_ && !recency_.empty() && !(recency_.back() == keep)) {
+        auto victim = entries_.find(recency_.back());
+        stats_.bytes -= victim->second.bytes;
+        entries_.erase(victim);
+        recency_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+void DbfCache::clear() {
+    entries_.clear();
+    recency_.clear();
+    pinned_.clear();
+    stats_.entries = 0;
+    stats_.bytes = 0;
+}
+
+// The deadline-point loop of analyze_basic_taskset(), on points and demands merged from the cached
+// curves in the order enumerate_deadline_points() would produce them
+
+bool analyze_taskset_cached(const Tasks* tasks, std::size_t num_tasks, TestingBound bound, DbfCache& cache, AnalysisScratch& scratch) {
+
+    typedef TimeTraits<double> Traits;
+    const int total_tasks = static_cast<int>(num_tasks);
+    INSTRUMENT_SCOPE(STAGE_EXACT);
+    INSTRUMENT_COUNT(COUNTER_TASKSETS, 1);
+    TaskSet& taskset = scratch.taskset;
+    load_taskset(tasks, num_tasks, taskset);
+    AnalysisResult& result = scratch.result;
+    result = AnalysisResult();
+
+    std::vector<int>& intervals_per_task_phase = scratch.intervals_per_task_phase;
+    std::vector<double>& beta_per_task = scratch.beta_per_task;
+    std::vector<double>& chunk_beta = scratch.chunk_beta;
+    intervals_per_task_phase.assign(num_tasks * MAX_PHASES, 1);
+    beta_per_task.assign(num_tasks, 0.0);
+    chunk_beta.assign(num_tasks, Traits::never());
+
+    double max_testing_time = 0.0;
+    for (int i = 0; i < total_tasks; i++) {
+        assert(tasks[i].phases >= 1 && tasks[i].phases <= MAX_PHASES);
+        for (int j = 0; j < tasks[i].phases; j++) {
+            beta_per_task[i] = std::max(beta_per_task[i], task_phase_wcet(tasks[i], j) + task_phase_cleanup(tasks[i], j));
+        }
+        max_testing_time = std::max(max_testing_time, tasks[i].deadline);
+    }
+    max_testing_time = Traits::grid_floor(max_testing_time);
+
+    std::vector<std::shared_ptr<const DbfCurve>>& curves = cache.pinned_;
+    std::vector<int>& cursor = cache.cursor_;
+    std::vector<DeadlineEvent>& heap = scratch.heap;
+    curves.resize(num_tasks);
+    cursor.assign(num_tasks, -1);
+    heap.clear();
+    for (int i = 0; i < total_tasks; i++) {
+        curves[i] = cache.lookup(tasks[i], max_testing_time);
+        if (!curves[i]->points.empty() && curves[i]->points[0] <= max_testing_time) {
+            heap.push_back(DeadlineEvent{curves[i]->points[0], i, 0});
+            std::push_heap(heap.begin(), heap.end(), later_deadline<double>);
+        }
+    }
+
+    bool schedulable = true;
+    while (!heap.empty() && schedulable) {
+        // Pass every breakpoint at td, then sum the curves in task order
+        double td = heap.front().point;
+        while (!heap.empty() && heap.front().point == td) {
+            std::pop_heap(heap.begin(), heap.end(), later_deadline<double>);
+            DeadlineEvent& e = heap.back();
+            const DbfCurve& curve = *curves[e.task];
+            cursor[e.task] = int(e.job);
+            if (++e.job < (long long)curve.points.size() && curve.points[e.job] <= max_testing_time) {
+                e.point = curve.points[e.job];
+                std::push_heap(heap.begin(), heap.end(), later_deadline<double>);
+            } else {
+                heap.pop_back();
+            }
+        }
+        double demand = 0.0;
+        for (int i = 0; i < total_tasks; i++) {
+            if (cursor[i] >= 0) {
+                demand += curves[i]->demand[cursor[i]];
+            }
+        }
+        double delta_td = td - demand;
+        INSTRUMENT_COUNT(COUNTER_DEADLINE_POINTS, 1);
+
+        if (delta_td < 0.0) {
+            result.verdict = ANALYSIS_DEMAND_EXCEEDED;
+            result.failing_td = td;
+            result.delta = delta_td;
+            INSTRUMENT_COUNT(COUNTER_EARLY_EXITS, 1);
+            schedulable = false;
+            break;
+        }
+
+        for (int i = 0; i < total_tasks && schedulable; i++) {
+            if (tasks[i].deadline > td) {
+                if (beta_per_task[i] - Traits::unit() > delta_td) {
+                    beta_per_task[i] = delta_td + Traits::unit();
+                }
+                if (beta_per_task[i] == chunk_beta[i]) {
+                    INSTRUMENT_COUNT(COUNTER_CHUNK_SKIPS, 1);
+                    continue; // Chunk counts only change with beta
+                }
+                chunk_beta[i] = beta_per_task[i];
+                for (int j = 0; j < tasks[i].phases; j++) {
+                    double cleanup = task_phase_cleanup(tasks[i], j);
+                    if (beta_per_task[i] > cleanup) {
+                        intervals_per_task_phase[i * MAX_PHASES + j] = compute_min_chunks(task_phase_wcet(tasks[i], j), cleanup, beta_per_task[i]);
+                    } else {
+                        result.verdict = ANALYSIS_CLEANUP_EXCEEDS_BETA;
+                        result.failing_td = td;
+                        result.delta = delta_td;
+                        result.failing_task = i;
+                        INSTRUMENT_COUNT(COUNTER_EARLY_EXITS, 1);
+                        schedulable = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Keep the curves cached, but do not hold them past the analysis
+    for (std::shared_ptr<const DbfCurve>& curve : curves) {
+        curve.reset();
+    }
+    if (!schedulable) {
+        return false;
+    }
+    return demand_test_beyond_window(taskset, max_testing_time, bound, scratch);
+}
+
+double compute_max_blocking(const std::vector<Tasks>& tasks, int td, DbfCache& cache) {
+    double dbf_task_set = 0.0;
+    for (const Tasks& task : tasks) {
+        if (task.deadline <= (double)td) {
+            dbf_task_set += dbf_curve_at(*cache.lookup(task, td), td);
+        }
+    }
+    return (double)td - dbf_task_set;
+}
@@ -0,0 +1,114 @@
+#ifndef MULTI_PHASE_DBF_CACHE_H
+#define MULTI_PHASE_DBF_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "multi-phase.h"
+
+// Content-addressed memo of per-task demand bound functions, for explorations that analyse many
+// task sets differing in a few tasks. The dbf of a task only depends on (T, D, C), so it is cached
+// under the bit patterns of those three values as a breakpoint list: the task's deadline points
+// grid_ceil(k*T + D) up to a horizon with the dbf from each point on. The deadline points of a task
+// set and its demand at them are then a k-way merge of the cached curves, without the divisions of
+// taskset_dbf(). Job counts are taken from the breakpoint index, so they are exact; taskset_dbf()
+// agrees up to floating-point rounding of (t - D) / T and the order of summation.
+//
+// The cache holds at most a byte budget of curves and evicts the least recently used ones. Lookups
+// hand out shared pointers, so a curve in use stays valid when it is evicted. A cache is not
+// thread-safe; keep one per worker, like the analysis scratch.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Default byte budget of a cache
+#define DBF_CACHE_BUDGET (64u << 20)
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// dbf of one task on the time grid up to 'horizon'
+typedef struct DbfCurve {
+    double period = 0.0;
+    double deadline = 0.0;
+    double wcet = 0.0;
+    double horizon = 0.0;               // Breakpoints cover (0, horizon]
+    std::vector<double> points;         // grid_ceil(k*T + D) <= horizon, sorted and without duplicates
+    std::vector<double> demand;         // dbf on [points[k], points[k + 1])
+} DbfCurve;
+
+typedef struct DbfCacheStats {
+    long long hits = 0;
+    long long misses = 0;               // Curves built, including ones rebuilt for a longer horizon
+    long long evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+} DbfCacheStats;
+
+class DbfCache {
+public:
+    explicit DbfCache(std::size_t budget_bytes = DBF_CACHE_BUDGET) : budget_(budget_bytes) {}
+
+    // Curve of 'task' covering at least (0, horizon]; a cached curve that is too short is rebuilt
+    // with at least twice its horizon, so that growing horizons cost amortized linear time
+    std::shared_ptr<const DbfCurve> lookup(const Tasks& task, double horizon);
+
+    void clear();
+    const DbfCacheStats& stats() const { return stats_; }
+
+    friend bool analyze_taskset_cached(const Tasks* tasks, std::size_t num_tasks, TestingBound bound, DbfCache& cache,
+                                       AnalysisScratch& scratch);
+
+private:
+    typedef struct DbfKey {
+        uint64_t period;
+        uint64_t deadline;
+        uint64_t wcet;
+        bool operator==(const DbfKey& other) const {
+            return period == other.period && deadline == other.deadline && wcet == other.wcet;
+        }
+    } DbfKey;
+
+    typedef struct DbfKeyHash {
+        std::size_t operator()(const DbfKey& key) const;
+    } DbfKeyHash;
+
+    typedef struct DbfEntry {
+        std::shared_ptr<const DbfCurve> curve;
+        std::list<DbfKey>::iterator use;    // Position in the recency list
+        std::size_t bytes;
+    } DbfEntry;
+
+    void evict_to_budget(const DbfKey& keep);
+
+    std::size_t budget_;
+    std::unordered_map<DbfKey, DbfEntry, DbfKeyHash> entries_;
+    std::list<DbfKey> recency_;             // Most recently used first
+    DbfCacheStats stats_;
+    std::vector<std::shared_ptr<const DbfCurve>> pinned_;   // Merge scratch: curves of the task set being analysed
+    std::vector<int> cursor_;                               // Merge scratch: last breakpoint of every curve passed
+};
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Builds the curve of a task up to 'horizon'
+void build_dbf_curve(const Tasks& task, double horizon, DbfCurve& curve);
+
+// dbf of a curve at a grid point t <= curve.horizon
+double dbf_curve_at(const DbfCurve& curve, double t);
+
+// analyze_taskset() with the deadline points and demands of the window merged from cached curves;
+// the demand check beyond the window is the uncached one
+bool analyze_taskset_cached(const Tasks* tasks, std::size_t num_tasks, TestingBound bound, DbfCache& cache, AnalysisScratch& scratch);
+
+// compute_max_blocking() from cached curves
+double compute_max_blocking(const std::vector<Tasks>& tasks, int td, DbfCache& cache);
+
+#endif
@@ -0,0 +1,552 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include <cmath>
+#include "multi_phase_experiment.h"
+#include "multi_phase_instrument.h"
+
+// Number parsing that rejects trailing garbage instead of silently truncating
+
+static bool parse_double(const std::string& text, double* value) {
+    char* end = nullptr;
+    errno = 0;
+    *value = std::strtod(text.c_str(), &end);
+    return !text.empty() && errno == 0 && *end == '\0';
+}
+
+static bool parse_integer(const std::string& text, long long* value) {
+    char* end = nullptr;
+    errno = 0;
+    *value = std::strtoll(text.c_str(), &end, 0);
+    return !text.empty() && errno == 0 && *end == '\0';
+}
+
+static std::string trim(const std::string& text) {
+    std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    std::size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// "a,b,c" or "first:last:step" (last included up to rounding)
+
+static bool parse_double_list(const std::string& text, std::vector<double>* values) {
+    values->clear();
+    std::size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        std::size_t second = text.find(':', colon + 1);
+        double first = 0.0, last = 0.0, step = 0.0;
+        if (second == std::string::npos || !parse_double(trim(text.substr(0, colon)), &first) ||
+            !parse_double(trim(text.substr(colon + 1, second - colon - 1)), &last) ||
+            !parse_double(trim(text.substr(second + 1)), &step) || step <= 0.0 || last < first) {
+            return false;
+        }
+        long long count = (long long)((last - first) / step + 1e-9) + 1;
+        for (long long k = 0; k < count; k++) {
+            values->push_back(first + k * step);
+        }
+        return true;
+    }
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        double value = 0.0;
+        if (!parse_double(trim(item), &value)) {
+            return false;
+        }
+        values->push_back(value);
+    }
+    return !values->empty();
+}
+
+static bool parse_int_list(const std::string& text, std::vector<int>* values) {
+    std::vector<double> numbers;
+    if (!parse_double_list(text, &numbers)) {
+        return false;
+    }
+    values->clear();
+    for (double number : numbers) {
+        if (number != double(int(number))) {
+            return false;
+        }
+        values->push_back(int(number));
+    }
+    return true;
+}
+
+static bool all_within(const std::vector<double>& values, double low, double high, bool open_low, bool open_high) {
+    for (double value : values) {
+        if (value < low || value > high || (open_low && value == low) || (open_high && value == high)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool set_experiment_option(ExperimentConfig& config, const std::string& key, const std::string& value, std::string* error) {
+
+    bool ok = true;
+    double number = 0.0;
+    long long integer = 0;
+
+    if (key == "utilizations") {
+        ok = parse_double_list(value, &config.utilizations) && all_within(config.utilizations, 0.0, 1e9, true, false);
+    } else if (key == "tasks") {
+        ok = parse_int_list(value, &config.task_counts);
+        for (int count : config.task_counts) {
+            ok = ok && count >= 1;
+        }
+    } else if (key == "phases") {
+        ok = parse_int_list(value, &config.phase_counts);
+        for (int count : config.phase_counts) {
+            ok = ok && count >= 1 && count <= MAX_PHASES;
+        }
+    } else if (key == "trust") {
+        ok = parse_double_list(value, &config.trust_probabilities) && all_within(config.trust_probabilities, 0.0, 1.0, false, false);
+    } else if (key == "tasksets") {
+        ok = parse_integer(value, &integer) && integer >= 1;
+        config.tasksets_per_point = integer;
+    } else if (key == "seed") {
+        ok = parse_integer(value, &integer);
+        config.seed = uint64_t(integer);
+    } else if (key == "threads") {
+        ok = parse_integer(value, &integer) && integer >= 0;
+        config.threads = int(integer);
+    } else if (key == "bound") {
+        if (value == "max_deadline") {
+            config.bound = BOUND_MAX_DEADLINE;
+        } else if (value == "busy_period") {
+            config.bound = BOUND_BUSY_PERIOD;
+        } else if (value == "la_lb") {
+            config.bound = BOUND_LA_LB;
+        } else if (value == "qpa") {
+            config.bound = BOUND_QPA;
+        } else {
+            ok = false;
+        }
+    } else if (key == "report") {
+        if (value == "none") {
+            config.report.format = REPORT_NONE;
+        } else if (value == "csv") {
+            config.report.format = REPORT_CSV;
+        } else if (value == "json") {
+            config.report.format = REPORT_JSON;
+        } else {
+            ok = false;
+        }
+    } else if (key == "bucket_width") {
+        ok = parse_double(value, &number) && number > 0.0 && number <= 1.0;
+        config.report.bucket_width = number;
+    } else if (key == "trace_every") {
+        ok = parse_integer(value, &integer) && integer >= 0;
+        config.report.trace_every = integer;
+    } else if (key == "ci_half_width") {
+        ok = parse_double(value, &number) && number >= 0.0 && number < 0.5;
+        config.curve.ci_half_width = number;
+        config.adaptive = number > 0.0;
+    } else if (key == "confidence") {
+        ok = parse_double(value, &number) && number > 0.0 && number < 1.0;
+        config.curve.confidence = number;
+    } else if (key == "batch") {
+        ok = parse_integer(value, &integer) && integer >= 1;
+        config.curve.batch = integer;
+    } else if (key == "skip_saturated") {
+        ok = parse_integer(value, &integer) && (integer == 0 || integer == 1);
+        config.curve.skip_saturated = integer == 1;
+    } else if (key == "utilization_algorithm") {
+        if (value == "uunifast_rounded") {
+            config.base.utilization_algorithm = UTIL_UUNIFAST_ROUNDED;
+        } else if (value == "uunifast") {
+            config.base.utilization_algorithm = UTIL_UUNIFAST;
+        } else if (value == "uunifast_discard") {
+            config.base.utilization_algorithm = UTIL_UUNIFAST_DISCARD;
+        } else if (value == "randfixedsum") {
+            config.base.utilization_algorithm = UTIL_RANDFIXEDSUM;
+        } else {
+            ok = false;
+        }
+    } else if (key == "sensitivity") {
+        if (value == "none") {
+            config.sensitivity = false;
+        } else if (value == "taskset" || value == "task") {
+            config.sensitivity = true;
+            config.sensitivity_options.per_task = value == "task";
+        } else {
+            ok = false;
+        }
+    } else if (key == "sensitivity_tolerance") {
+        ok = parse_double(value, &number) && number > 0.0 && number < 1.0;
+        config.sensitivity_options.tolerance = number;
+    } else if (key == "simulate") {
+        if (value == "none") {
+            config.simulate = false;
+        } else if (value == "taskset" || value == "task") {
+            config.simulate = true;
+            config.simulate_per_task = value == "task";
+        } else {
+            ok = false;
+        }
+    } else if (key == "sim_horizon") {
+        ok = parse_double(value, &number) && number > 0.0 && std::isfinite(number);
+        config.sim_horizon = number;
+    } else if (key == "instrument") {
+        ok = !value.empty();
+        config.instrument_path = value;
+    } else if (key == "min_period") {
+        ok = parse_double(value, &number) && number >= GRANULARITY;
+        config.base.min_period = number;
+    } else if (key == "max_period") {
+        ok = parse_double(value, &number) && number >= GRANULARITY;
+        config.base.max_period = number;
+    } else if (key == "q_fraction") {
+        ok = parse_double(value, &number) && number >= 0.0 && number <= 0.5;
+        config.base.q_fraction = number;
+    } else if (key == "deadline_factor") {
+        ok = parse_double(value, &number) && number > 0.0 && number <= 1.0;
+        config.base.deadline_factor = number;
+    } else {
+        *error = "unknown option '" + key + "'";
+        return false;
+    }
+
+    if (!ok) {
+        *error = "invalid value '" + value + "' for option '" + key + "'";
+        return false;
+    }
+    if (config.base.max_period < config.base.min_period) {
+        *error = "max_period is smaller than min_period";
+        return false;
+    }
+    return true;
+}
+
+bool load_experiment_config(const char* path, ExperimentConfig& config, std::string* error) {
+
+    std::ifstream file(path);
+    if (!file) {
+        *error = std::string("cannot open config file '") + path + "'";
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        std::size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            *error = std::string(path) + ":" + std::to_string(line_number) + ": expected 'key = value'";
+            return false;
+        }
+        if (!set_experiment_option(config, trim(line.substr(0, equals)), trim(line.substr(equals + 1)), error)) {
+            *error = std::string(path) + ":" + std::to_string(line_number) + ": " + *error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_experiment_args(int argc, char* argv[], ExperimentConfig& config, std::string* error) {
+
+    for (int k = 1; k < argc; k++) {
+        std::string arg = argv[k];
+        if (arg.compare(0, 2, "--") != 0 || k + 1 >= argc) {
+            *error = "expected '--option value', got '" + arg + "'";
+            return false;
+        }
+        std::string key = arg.substr(2);
+        std::string value = argv[++k];
+        bool ok = key == "config" ? load_experiment_config(value.c_str(), config, error)
+                                  : set_experiment_option(config, key, value, error);
+        if (!ok) {
+            return false;
+        }
+    }
+    return validate_experiment_config(config, error);
+}
+
+bool validate_experiment_config(const ExperimentConfig& config, std::string* error) {
+
+    bool multi_unit = config.base.utilization_algorithm == UTIL_UUNIFAST_DISCARD ||
+                      config.base.utilization_algorithm == UTIL_RANDFIXEDSUM;
+    for (double utilization : config.utilizations) {
+        for (int num_tasks : config.task_counts) {
+            if (multi_unit ? utilization >= num_tasks : utilization >= 1.0) {
+                *error = "utilization " + std::to_string(utilization) + " is too large for " + std::to_string(num_tasks) +
+                         " tasks" + (multi_unit ? "" : " (use utilization_algorithm uunifast_discard or randfixedsum above 1)");
+                return false;
+            }
+        }
+    }
+    if (config.sensitivity && config.simulate) {
+        *error = "sensitivity and simulate are separate reports; choose one";
+        return false;
+    }
+    if (!config.instrument_path.empty() && !MULTI_PHASE_INSTRUMENT) {
+        *error = "instrumentation is compiled out (build with -DMULTI_PHASE_INSTRUMENT=1)";
+        return false;
+    }
+    return true;
+}
+
+void run_experiment(const ExperimentConfig& config, const std::function<void(const ExperimentPoint& point)>& on_point) {
+
+    ExperimentPoint point;
+    point.params = config.base;
+    point.tasksets = config.tasksets_per_point;
+    double z = confidence_quantile(config.curve.confidence);
+    ResultReport* report = config.report.format != REPORT_NONE ? &point.report : nullptr;
+
+    for (int num_tasks : config.task_counts) {
+        for (int num_phases : config.phase_counts) {
+            for (double trust_probability : config.trust_probabilities) {
+                point.params.num_tasks = num_tasks;
+                point.params.num_phases = num_phases;
+                point.params.trust_probability = trust_probability;
+
+                if (config.adaptive) {
+                    CurveOptions curve = config.curve;
+                    curve.max_tasksets = config.tasksets_per_point;
+                    for (CurvePoint& curve_point : run_acceptance_curve(point.params, config.utilizations, curve, config.seed,
+                                                                        config.threads, config.bound, config.report)) {
+                        point.params.max_utilization = curve_point.utilization;
+                        point.tasksets = curve_point.tasksets;
+                        point.counters = curve_point.counters;
+                        point.ratio = curve_point.ratio;
+                        point.ci_low = curve_point.ci_low;
+                        point.ci_high = curve_point.ci_high;
+                        point.inferred = curve_point.inferred;
+                        point.report = std::move(curve_point.report);
+                        on_point(point);
+                    }
+                    continue;
+                }
+
+                for (double utilization : config.utilizations) {
+                    point.params.max_utilization = utilization;
+                    point.report = ResultReport();
+                    point.report.options = config.report;
+                    point.counters = run_taskset_sweep(point.params, config.tasksets_per_point, config.seed, config.threads,
+                                                       config.bound, report);
+                    point.ratio = double(point.counters.total_scheduled) / point.tasksets;
+                    wilson_interval(point.counters.total_scheduled, point.tasksets, z, &point.ci_low, &point.ci_high);
+                    on_point(point);
+                }
+            }
+        }
+    }
+}
+
+void print_experiment_header(std::ostream& out) {
+    out << "utilization,num_tasks,num_phases,trust_probability,tasksets,scheduled,non_scheduled,schedulable_ratio,ci_low,ci_high,inferred\n";
+}
+
+void print_experiment_point(std::ostream& out, const ExperimentPoint& point) {
+    out << point.params.max_utilization << "," << point.params.num_tasks << "," << point.params.num_phases << ","
+        << point.params.trust_probability << "," << point.tasksets << "," << point.counters.total_scheduled << ","
+        << point.counters.total_non_scheduled << "," << point.ratio << "," << point.ci_low << "," << point.ci_high << ","
+        << (point.inferred ? 1 : 0) << "\n";
+    out.flush();
+}
+
+// Verdict counts as "name":count members of a JSON object
+
+static void write_verdicts_json(std::ostream& out, const UtilizationBucket& bucket) {
+    for (int v = 0; v < ANALYSIS_NUM_VERDICTS; v++) {
+        out << (v == 0 ? "" : ",") << "\"" << analysis_verdict_name(AnalysisVerdict(v)) << "\":" << bucket.verdicts[v];
+    }
+}
+
+static void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c == '\n') {
+            out << "\\n";
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void write_experiment_report(std::ostream& out, const std::vector<ExperimentPoint>& points, ReportFormat format) {
+
+    if (format == REPORT_CSV) {
+        out << "utilization,num_tasks,num_phases,trust_probability,bucket_low,bucket_high,tasksets,accepted,acceptance_ratio";
+        for (int v = 1; v < ANALYSIS_NUM_VERDICTS; v++) {
+            out << "," << analysis_verdict_name(AnalysisVerdict(v));
+        }
+        out << "\n";
+        for (const ExperimentPoint& point : points) {
+            for (std::size_t b = 0; b < point.report.buckets.size(); b++) {
+                const UtilizationBucket& bucket = point.report.buckets[b];
+                if (bucket.tasksets == 0) {
+                    continue;
+                }
+                out << point.params.max_utilization << "," << point.params.num_tasks << "," << point.params.num_phases << ","
+                    << point.params.trust_probability << "," << bucket_utilization(point.report, b) << ","
+                    << bucket_utilization(point.report, b + 1) << "," << bucket.tasksets << ","
+                    << bucket.verdicts[ANALYSIS_SCHEDULABLE] << "," << acceptance_ratio(bucket);
+                for (int v = 1; v < ANALYSIS_NUM_VERDICTS; v++) {
+                    out << "," << bucket.verdicts[v];
+                }
+                out << "\n";
+            }
+        }
+        for (const ExperimentPoint& point : points) {
+            for (const TraceEntry& entry : point.report.trace) {
+                std::stringstream lines(entry.text);
+                std::string line;
+                while (std::getline(lines, line)) {
+                    out << "# " << line << "\n";
+                }
+            }
+        }
+    } else if (format == REPORT_JSON) {
+        out << "[";
+        for (std::size_t p = 0; p < points.size(); p++) {
+            const ExperimentPoint& point = points[p];
+            out << (p == 0 ? "" : ",") << "\n  {\"utilization\":" << point.params.max_utilization
+                << ",\"num_tasks\":" << point.params.num_tasks << ",\"num_phases\":" << point.params.num_phases
+                << ",\"trust_probability\":" << point.params.trust_probability << ",\"tasksets\":" << point.tasksets
+                << ",\"scheduled\":" << point.counters.total_scheduled << ",\"ratio\":" << point.ratio
+                << ",\"ci_low\":" << point.ci_low << ",\"ci_high\":" << point.ci_high
+                << ",\"inferred\":" << (point.inferred ? "true" : "false") << ",\"buckets\":[";
+            bool first = true;
+            for (std::size_t b = 0; b < point.report.buckets.size(); b++) {
+                const UtilizationBucket& bucket = point.report.buckets[b];
+                if (bucket.tasksets == 0) {
+                    continue;
+                }
+                out << (first ? "" : ",") << "\n    {\"low\":" << bucket_utilization(point.report, b)
+                    << ",\"high\":" << bucket_utilization(point.report, b + 1) << ",\"tasksets\":" << bucket.tasksets
+                    << ",\"acceptance_ratio\":" << acceptance_ratio(bucket) << ",\"verdicts\":{";
+                write_verdicts_json(out, bucket);
+                out << "}}";
+                first = false;
+            }
+            out << "],\"trace\":[";
+            for (std::size_t t = 0; t < point.report.trace.size(); t++) {
+                out << (t == 0 ? "" : ",") << "\n    {\"index\":" << point.report.trace[t].index << ",\"text\":";
+                write_json_string(out, point.report.trace[t].text);
+                out << "}";
+            }
+            out << "]}";
+        }
+        out << "\n]\n";
+    }
+    out.flush();
+}
+
+// Infinity as "inf" in both formats' number columns
+
+static void write_factor(std::ostream& out, double factor) {
+    if (std::isinf(factor)) {
+        out << "inf";
+    } else {
+        out << factor;
+    }
+}
+
+static void write_factors(std::ostream& out, const SensitivityFactors& factors) {
+    write_factor(out, factors.cleanup_scaling);
+    out << ",";
+    write_factor(out, factors.cleanup_fraction);
+    out << ",";
+    write_factor(out, factors.wcet_scaling);
+}
+
+void write_sensitivity_report(std::ostream& out, const ExperimentConfig& config) {
+
+    out << "utilization,num_tasks,num_phases,trust_probability,taskset,task,schedulable,cleanup_scaling,cleanup_fraction,wcet_scaling\n";
+    GeneratorParams params = config.base;
+    std::vector<SensitivityResult> results;
+    for (int num_tasks : config.task_counts) {
+        for (int num_phases : config.phase_counts) {
+            for (double trust_probability : config.trust_probabilities) {
+                for (double utilization : config.utilizations) {
+                    params.num_tasks = num_tasks;
+                    params.num_phases = num_phases;
+                    params.trust_probability = trust_probability;
+                    params.max_utilization = utilization;
+                    run_sensitivity_sweep(params, config.tasksets_per_point, config.seed, config.threads, config.bound,
+                                          config.sensitivity_options, results);
+
+                    // Task set row (task -1), then one row per task
+                    for (std::size_t k = 0; k < results.size(); k++) {
+                        const SensitivityResult& result = results[k];
+                        for (int i = -1; i < static_cast<int>(result.per_task.size()); i++) {
+                            out << utilization << "," << num_tasks << "," << num_phases << "," << trust_probability << ","
+                                << k << "," << i << "," << (result.schedulable ? 1 : 0) << ",";
+                            write_factors(out, i < 0 ? result.taskset : result.per_task[i]);
+                            out << "\n";
+                        }
+                    }
+                }
+            }
+        }
+    }
+    out.flush();
+}
+
+void write_simulation_report(std::ostream& out, const ExperimentConfig& config) {
+
+    out << "utilization,num_tasks,num_phases,trust_probability,taskset,task,schedulable,jobs,deadline_misses,"
+           "max_response_time,mean_response_time,preemptions,cleanup_time,max_nonpreemptive,beta\n";
+    GeneratorParams params = config.base;
+    std::vector<SimTasksetResult> results;
+    for (int num_tasks : config.task_counts) {
+        for (int num_phases : config.phase_counts) {
+            for (double trust_probability : config.trust_probabilities) {
+                for (double utilization : config.utilizations) {
+                    params.num_tasks = num_tasks;
+                    params.num_phases = num_phases;
+                    params.trust_probability = trust_probability;
+                    params.max_utilization = utilization;
+                    run_simulation_sweep(params, config.tasksets_per_point, config.seed, config.threads, config.bound,
+                                         config.sim_horizon, results);
+
+                    // Task set row (task -1), then one row per task if requested
+                    for (std::size_t k = 0; k < results.size(); k++) {
+                        const SimTasksetResult& result = results[k];
+                        const SimResult& sim = result.sim;
+                        int rows = config.simulate_per_task ? static_cast<int>(sim.per_task.size()) : 0;
+                        for (int i = -1; i < rows; i++) {
+                            out << utilization << "," << num_tasks << "," << num_phases << "," << trust_probability << ","
+                                << k << "," << i << "," << (result.schedulable ? 1 : 0) << ",";
+                            if (i < 0) {
+                                double total_response = 0.0;
+                                double max_nonpreemptive = 0.0;
+                                for (const SimTaskStats& stats : sim.per_task) {
+                                    total_response += stats.total_response_time;
+                                    max_nonpreemptive = std::max(max_nonpreemptive, stats.max_nonpreemptive);
+                                }
+                                out << sim.jobs << "," << sim.deadline_misses << "," << sim.max_response_time << ","
+                                    << (sim.jobs > 0 ? total_response / sim.jobs : 0.0) << "," << sim.preemptions << ","
+                                    << sim.cleanup_time << "," << max_nonpreemptive << ",-1\n";
+                            } else {
+                                const SimTaskStats& stats = sim.per_task[i];
+                                out << stats.jobs << "," << stats.deadline_misses << "," << stats.max_response_time << ","
+                                    << (stats.jobs > 0 ? stats.total_response_time / stats.jobs : 0.0) << ","
+                                    << stats.preemptions << "," << stats.cleanup_time << "," << stats.max_nonpreemptive << ","
+                                    << result.beta_per_task[i] << "\n";
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    out.flush();
+}
@@ -0,0 +1,118 @@
+#ifndef MULTI_PHASE_EXPERIMENT_H
+#define MULTI_PHASE_EXPERIMENT_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "multi_phase_generator.h"
+#include "multi_phase_bound.h"
+#include "multi_phase_sweep.h"
+#include "multi_phase_curve.h"
+#include "multi_phase_sensitivity.h"
+#include "multi_phase_sim.h"
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Grid of experiment points run by one process. Every combination of utilization, task count,
+// phase count and trust probability is one point; the remaining generator parameters are shared.
+// Options come from the command line (--key value) or from a config file with one "key = value"
+// per line ('#' starts a comment); both accept the same keys:
+//   utilizations, tasks, phases, trust     lists "a,b,c" or ranges "first:last:step"
+//   tasksets                               task sets per point
+//   seed, threads                          sweep master seed and worker count (0 = all cores)
+//   bound                                  max_deadline | busy_period | la_lb | qpa
+//   min_period, max_period, q_fraction, deadline_factor
+//   utilization_algorithm                  uunifast_rounded | uunifast | uunifast_discard | randfixedsum; the
+//                                          last two accept utilizations up to (not including) the task count
+//   report                                 none | csv | json (per-bucket report written once at the end)
+//   bucket_width, trace_every              utilization bucket width and verbose trace sampling of the report
+//   ci_half_width                          > 0 samples every point adaptively until its Wilson interval is
+//                                          this narrow (tasksets is then the most per point); 0 = fixed count
+//   confidence, batch, skip_saturated      interval level, batch size and 0/1 inference of saturated points
+//   sensitivity                            none | taskset | task: instead of acceptance ratios, the critical
+//                                          clean up and WCET factors of every task set (and of every task)
+//   sensitivity_tolerance                  relative precision of the WCET factors
+//   simulate                               none | taskset | task: instead of acceptance ratios, an EDF simulation
+//                                          of every task set (and its tasks) with the chunk counts of its analysis
+//   sim_horizon                            jobs are released in [0, sim_horizon)
+//   instrument                             file the counters and stage latencies of the run are written to as
+//                                          JSON (builds with MULTI_PHASE_INSTRUMENT=1 only)
+typedef struct ExperimentConfig {
+    std::vector<double> utilizations = {MAX_UTILIZATION};
+    std::vector<int> task_counts = {NUM_TASKS};
+    std::vector<int> phase_counts = {NUM_PHASES};
+    std::vector<double> trust_probabilities = {TRUST_PROBABILITY};
+    GeneratorParams base;                           // Parameters that are not swept
+    long long tasksets_per_point = NUM_TASKSETS;
+    uint64_t seed = SWEEP_MASTER_SEED;
+    int threads = SWEEP_THREADS;
+    TestingBound bound = DEFAULT_TESTING_BOUND;
+    ReportOptions report;
+    bool adaptive = false;                          // Set by a ci_half_width > 0
+    CurveOptions curve;
+    bool sensitivity = false;                       // Write the sensitivity report instead of the acceptance ratios
+    SensitivityOptions sensitivity_options;
+    bool simulate = false;                          // Write the simulation report instead of the acceptance ratios
+    bool simulate_per_task = false;                 // One simulation row per task as well
+    double sim_horizon = SIM_DEFAULT_HORIZON;
+    std::string instrument_path;                    // Empty: no instrumentation report
+} ExperimentConfig;
+
+// Outcome of one grid point
+typedef struct ExperimentPoint {
+    GeneratorParams params;
+    long long tasksets = 0;
+    SweepCounters counters;
+    double ratio = 0.0;                             // Acceptance ratio and its Wilson interval
+    double ci_low = 0.0;
+    double ci_high = 1.0;
+    bool inferred = false;                          // Adaptive mode: taken from saturated neighbours, not sampled
+    ResultReport report;                            // Filled only if config.report.format != REPORT_NONE
+} ExperimentPoint;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Applies one option; on invalid input returns false and describes the problem in *error
+bool set_experiment_option(ExperimentConfig& config, const std::string& key, const std::string& value, std::string* error);
+
+// Applies every option of a config file
+bool load_experiment_config(const char* path, ExperimentConfig& config, std::string* error);
+
+// Applies "--key value" pairs; "--config FILE" loads a file at that position, so later options override it.
+// The combined configuration is checked with validate_experiment_config().
+bool parse_experiment_args(int argc, char* argv[], ExperimentConfig& config, std::string* error);
+
+// Checks the constraints between options, e.g. that every utilization is below 1 unless the
+// utilization algorithm supports larger totals
+bool validate_experiment_config(const ExperimentConfig& config, std::string* error);
+
+// Runs the sweep of every grid point in one process and reports each point as soon as it is done.
+// Task set k of every point is generated from stream k of the same master seed. In adaptive mode
+// the utilizations of one (tasks, phases, trust) combination form a curve and are reported together,
+// in ascending order, once the curve is done.
+void run_experiment(const ExperimentConfig& config, const std::function<void(const ExperimentPoint& point)>& on_point);
+
+// CSV report of the grid points
+void print_experiment_header(std::ostream& out);
+void print_experiment_point(std::ostream& out, const ExperimentPoint& point);
+
+// Acceptance ratio per utilization bucket of every grid point, in config.report.format. CSV puts the
+// sampled trace after the table as '#' comment lines, JSON as a "trace" array per point.
+void write_experiment_report(std::ostream& out, const std::vector<ExperimentPoint>& points, ReportFormat format);
+
+// Sensitivity analysis of every task set of the grid as CSV, one row per task set (task -1) and,
+// with per-task factors, one per task; task set k of every point is the one the sweep draws
+void write_sensitivity_report(std::ostream& out, const ExperimentConfig& config);
+
+// Simulation of every task set of the grid as CSV, one row per task set (task -1) and, per task if
+// requested, one per task: deadline misses, response times, preemptions, clean up time and the longest
+// non-preemptive region next to beta (-1 on the task set row)
+void write_simulation_report(std::ostream& out, const ExperimentConfig& config);
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef MULTI_PHASE_FILTER_H
+#define MULTI_PHASE_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "multi_phase_core.h"
+
+// Pre-filters that decide most task sets in O(n) (O(k n^2) for the approximate dbf) before the exact
+// deadline-point analysis runs. Clean up costs are not part of the dbf of this test; they only have
+// to fit into beta, which shrinks to delta(td) + 1 at the deadline points before a task's deadline.
+// A filter therefore accepts only if a lower bound on delta over all deadline points leaves room for
+// every clean up cost, and rejects only if the exact test is certain to reject:
+//   utilization    U = sum(Ci / Ti) > 1 fails the demand test beyond the window (not for BOUND_MAX_DEADLINE)
+//   first point    the exact test's first step; a failure there is the exact verdict
+//   density        dbf(t) <= t * sum(Ci / min(Di, Ti)), so delta(t) >= (1 - density) * min(Di)
+//   approx dbf     dbf exact for the first FILTER_APPROX_JOBS jobs and linear after [8]; with U <= 1,
+//                  t - dbf'(t) is smallest at the first k deadlines of some task
+// The sufficient tests work in double and keep a margin of FILTER_EPSILON, so rounding can only make
+// them inconclusive, never wrong.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Jobs per task the approximate dbf counts exactly before switching to its linear bound
+#define FILTER_APPROX_JOBS 2
+
+// Relative safety margin of the sufficient tests
+#define FILTER_EPSILON 1e-9
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Runs the filters on tasks[0 .. num_tasks) (loaded into scratch.taskset). Returns the deciding tier
+// and sets scratch.result, or returns TIER_EXACT if no filter decides (the exact analysis then
+// overwrites the result).
+template <class Task, class Time>
+AnalysisTier prefilter_taskset(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch);
+
+// prefilter_taskset(), then the exact analysis on the inconclusive task sets
+template <class Task, class Time>
+bool analyze_basic_taskset_tiered(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch);
+
+// ====================
+// TEMPLATE DEFINITIONS
+// ====================
+
+// Lower bound on beta_i at the end of the exact loop is min(beta_init_i, delta_lower + unit); every
+// phase's clean up cost has to stay strictly below it
+
+template <class Task, class Time>
+bool cleanup_fits(const Task* tasks, std::size_t num_tasks, double delta_lower) {
+    typedef TimeTraits<Time> Traits;
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        double beta_init = 0.0;
+        double max_cleanup = 0.0;
+        for (int j = 0; j < tasks[i].phases; j++) {
+            double cleanup = Traits::to_double(task_phase_cleanup(tasks[i], j));
+            beta_init = std::max(beta_init, Traits::to_double(task_phase_wcet(tasks[i], j)) + cleanup);
+            max_cleanup = std::max(max_cleanup, cleanup);
+        }
+        double beta_lower = std::min(beta_init, delta_lower + Traits::to_double(Traits::unit()));
+        if (!(beta_lower > max_cleanup + FILTER_EPSILON * (1.0 + max_cleanup))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Upper bound on the dbf of slot i at t: counts deadlines up to and including t, as the exact dbf
+// does, and jobs within FILTER_EPSILON of a boundary. From the FILTER_APPROX_JOBS-th deadline
+// on it is the line Ci * ((t - Di) / Ti + 1), which meets the step function there without a jump.
+
+template <class Time>
+double approx_dbf_upper(const BasicTaskSet<Time>& taskset, std::size_t i, double t) {
+    typedef TimeTraits<Time> Traits;
+    double period = Traits::to_double(taskset.period[i]);
+    double deadline = Traits::to_double(taskset.deadline[i]);
+    double wcet = Traits::to_double(taskset.wcet[i]);
+    double jobs = (t - deadline) / period;
+    if (jobs < -FILTER_EPSILON) {
+        return 0.0;
+    }
+    double counted = std::floor(jobs + FILTER_EPSILON) + 1.0;
+    return counted < FILTER_APPROX_JOBS ? counted * wcet : std::max(counted, jobs + 1.0) * wcet;
+}
+
+template <class Task, class Time>
+AnalysisTier prefilter_taskset(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch) {
+    typedef TimeTraits<Time> Traits;
+    BasicTaskSet<Time>& taskset = scratch.taskset;
+    BasicAnalysisResult<Time>& result = scratch.result;
+    INSTRUMENT_SCOPE(STAGE_PREFILTER);
+    INSTRUMENT_SCRATCH_GROWTH(scratch);
+    load_taskset(tasks, num_tasks, taskset);
+    if (num_tasks == 0) {
+        return TIER_EXACT;
+    }
+
+    // Utilization
+    double util = compute_demand_utilization(taskset);
+    if (bound != BOUND_MAX_DEADLINE && util > 1.0) {
+        result = BasicAnalysisResult<Time>();
+        result.verdict = ANALYSIS_OVERLOADED;
+        result.tier = TIER_UTILIZATION;
+        result.failing_td = Traits::never();
+        return TIER_UTILIZATION;
+    }
+
+    // First deadline point, exactly as the first iteration of analyze_basic_taskset()
+    Time min_deadline = taskset.deadline[0];
+    Time max_deadline = taskset.deadline[0];
+    for (std::size_t i = 1; i < num_tasks; i++) {
+        min_deadline = std::min(min_deadline, taskset.deadline[i]);
+        max_deadline = std::max(max_deadline, taskset.deadline[i]);
+    }
+    Time td = std::max(Traits::grid_ceil(min_deadline), Traits::unit());
+    if (td <= Traits::grid_floor(max_deadline)) {
+        Time delta_td = td - taskset_dbf(taskset, td);
+        INSTRUMENT_COUNT(COUNTER_DEADLINE_POINTS, 1);
+        INSTRUMENT_COUNT(COUNTER_DBF_EVALUATIONS, 1);
+        result = BasicAnalysisResult<Time>();
+        result.tier = TIER_FIRST_POINT;
+        result.failing_td = td;
+        result.delta = delta_td;
+        if (delta_td < Traits::zero()) {
+            result.verdict = ANALYSIS_DEMAND_EXCEEDED;
+            return TIER_FIRST_POINT;
+        }
+        for (std::size_t i = 0; i < num_tasks; i++) {
+            if (tasks[i].deadline > td) {
+                Time beta = Traits::zero();
+                for (int j = 0; j < tasks[i].phases; j++) {
+                    beta = std::max(beta, task_phase_wcet(tasks[i], j) + task_phase_cleanup(tasks[i], j));
+                }
+                if (beta - Traits::unit() > delta_td) {
+                    beta = delta_td + Traits::unit();
+                }
+                for (int j = 0; j < tasks[i].phases; j++) {
+                    if (!(beta > task_phase_cleanup(tasks[i], j))) {
+                        result.verdict = ANALYSIS_CLEANUP_EXCEEDS_BETA;
+                        result.failing_task = int(i);
+                        return TIER_FIRST_POINT;
+                    }
+                }
+            }
+        }
+    }
+
+    // Both sufficient tests need the demand to stay below t for all t, which requires U < 1
+    if (util > 1.0 - FILTER_EPSILON) {
+        return TIER_EXACT;
+    }
+    double scale = Traits::to_double(max_deadline);
+    double margin = FILTER_EPSILON * (1.0 + scale);
+
+    // Density
+    double density = 0.0;
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        density += Traits::to_double(taskset.wcet[i]) / Traits::to_double(std::min(taskset.deadline[i], taskset.period[i]));
+    }
+    if (density <= 1.0 - FILTER_EPSILON &&
+        cleanup_fits<Task, Time>(tasks, num_tasks, (1.0 - density) * Traits::to_double(min_deadline) - margin)) {
+        result = BasicAnalysisResult<Time>();
+        result.tier = TIER_DENSITY;
+        return TIER_DENSITY;
+    }
+
+    // Approximate dbf at the first FILTER_APPROX_JOBS deadlines of every task
+    double delta_lower = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        for (int k = 0; k < FILTER_APPROX_JOBS; k++) {
+            double t = Traits::to_double(taskset.deadline[i]) + k * Traits::to_double(taskset.period[i]);
+            double demand = 0.0;
+            for (std::size_t l = 0; l < num_tasks; l++) {
+                demand += approx_dbf_upper(taskset, l, t);
+            }
+            delta_lower = std::min(delta_lower, t - demand);
+        }
+    }
+    if (delta_lower - margin >= 0.0 && cleanup_fits<Task, Time>(tasks, num_tasks, delta_lower - margin)) {
+        result = BasicAnalysisResult<Time>();
+        result.tier = TIER_APPROX_DBF;
+        return TIER_APPROX_DBF;
+    }
+
+    return TIER_EXACT;
+}
+
+template <class Task, class Time>
+bool analyze_basic_taskset_tiered(const Task* tasks, std::size_t num_tasks, TestingBound bound, BasicAnalysisScratch<Time>& scratch) {
+    AnalysisTier tier = prefilter_taskset(tasks, num_tasks, bound, scratch);
+    if (tier != TIER_EXACT) {
+        return scratch.result.verdict == ANALYSIS_SCHEDULABLE;
+    }
+    return analyze_basic_taskset_dispatch(tasks, num_tasks, bound, scratch);
+}
+
+// [8] K. Albers, F. Slomka, "An event stream driven approximation for the analysis of real-time systems", ECRTS 2004
+
+#endif
@@ -4,22 +4,20 @@
 #include <cassert>
 #include <cmath>
 #include "multi_phase_generator.h"
+#include "multi_phase_instrument.h"
 
 // Generate task utilizations (Ui = Ci / Ti) using the UUnifast algorithm [1] (for unbiased distribution)
 
-void generate_task_utilizations(std::vector<Tasks>& tasks, double max_util) {
+void generate_task_utilizations(std::vector<Tasks>& tasks, double max_util, GeneratorContext& ctx) {
     
     assert(!tasks.empty() && max_util > 0.0 && max_util < 1.0);
 
     double sum_util = max_util;
     double rem_sum_util = 0.0;
 
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
 
     for (size_t i = 0; i < tasks.size() - 1; i++) {
-        rem_sum_util = sum_util * pow(dist(gen), 1.0 / (tasks.size() - i));
+        rem_sum_util = sum_util * pow(ctx.uniform(), 1.0 / (tasks.size() - i));
         tasks[i].utilization = sum_util - rem_sum_util;
         tasks[i].utilization = std::round(tasks[i].utilization * 100) / 100.0;
         sum_util = rem_sum_util;
@@ -30,43 +28,57 @@ void generate_task_utilizations(std::vector<Tasks>& tasks, double max_util) {
     assert(sum_util >= 0.0 && sum_util <= max_util);
 }
 
+// Same with one of the algorithms of multi_phase_utilization.h; the sampler is prepared for this task set
+
+void generate_task_utilizations(std::vector<Tasks>& tasks, double total_util, UtilizationAlgorithm algorithm,
+                                UtilizationSampler& sampler, GeneratorContext& ctx) {
+
+    sampler.prepare(algorithm, static_cast<int>(tasks.size()), total_util);
+    const double* out = sampler.sample(ctx);
+    for (size_t i = 0; i < tasks.size(); i++) {
+        tasks[i].utilization = out[i];
+    }
+}
+
 // Generate task periods Ti according as per log-uniform distribution [2]
 
-void generate_task_periods(std::vector<Tasks>& tasks) {
+void generate_task_periods(std::vector<Tasks>& tasks, GeneratorContext& ctx) {
+    generate_task_periods(tasks, MIN_PERIOD, MAX_PERIOD, ctx);
+}
+
+void generate_task_periods(std::vector<Tasks>& tasks, double min_period, double max_period, GeneratorContext& ctx) {
     
-    assert(!tasks.empty());
+    assert(!tasks.empty() && min_period >= GRANULARITY && max_period >= min_period);
     
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_real_distribution<double> dist(log(MIN_PERIOD), log(MAX_PERIOD + GRANULARITY));
 
     for (int i = 0; i < static_cast<int>(tasks.size()); i++) {
-        double random_number = dist(gen);
+        double random_number = ctx.uniform(log(min_period), log(max_period + GRANULARITY));
         tasks[i].period = std::floor(std::exp(random_number) / GRANULARITY) * GRANULARITY;
-        assert(tasks[i].period >= MIN_PERIOD && tasks[i].period <= (MAX_PERIOD + GRANULARITY));
+        assert(tasks[i].period >= min_period && tasks[i].period <= (max_period + GRANULARITY));
     }
 }
 
 // Determine the worst-case execution times and cleanup costs fore each task 
 // --> Ci = Ui * Ti, Qi = QF * Ci (if p < ptrust), 0 (otherwise)
 
-void generate_task_wcets(std::vector<Tasks>& tasks) {
+void generate_task_wcets(std::vector<Tasks>& tasks, GeneratorContext& ctx) {
+    generate_task_wcets(tasks, TRUST_PROBABILITY, Q_FRACTION, ctx);
+}
+
+void generate_task_wcets(std::vector<Tasks>& tasks, double trust_probability, double q_fraction, GeneratorContext& ctx) {
 
-    assert(!tasks.empty());
+    assert(!tasks.empty() && q_fraction >= 0.0 && q_fraction <= 0.5);
 
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
 
     double sum = 0.0;
 
     for (int i = 0; i < static_cast<int>(tasks.size()); i++) {
-        double random_number = dist(gen);
-	tasks[i].ptrust = TRUST_PROBABILITY;
+        double random_number = ctx.uniform();
+	tasks[i].ptrust = trust_probability;
         sum = tasks[i].period * tasks[i].utilization;
 
 	if (random_number < tasks[i].ptrust) {
-	    tasks[i].cleanup = Q_FRACTION * sum;
+	    tasks[i].cleanup = q_fraction * sum;
 	    tasks[i].wcet = sum - tasks[i].cleanup;
 	}
 	else {
@@ -81,12 +93,14 @@ void generate_task_wcets(std::vector<Tasks>& tasks) {
 
 // Generates task deadlines Di according to the uniform distribution in the range defined by [3]
 
-void generate_task_deadlines(std::vector<Tasks>& tasks) {
+void generate_task_deadlines(std::vector<Tasks>& tasks, GeneratorContext& ctx) {
+    generate_task_deadlines(tasks, DEADLINE_FACTOR, ctx);
+}
+
+void generate_task_deadlines(std::vector<Tasks>& tasks, double deadline_factor, GeneratorContext& ctx) {
 
-    assert(!tasks.empty());
+    assert(!tasks.empty() && deadline_factor > 0.0 && deadline_factor <= 1.0);
  
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
 
     double min_deadline = 0.0;
     double max_deadline = 0.0;
@@ -105,29 +119,97 @@ void generate_task_deadlines(std::vector<Tasks>& tasks) {
         // assert(tasks[i].deadline >= MIN_DEADLINE_FACTOR * tasks[i].period - 1 && tasks[i].deadline <= MAX_DEADLINE_FACTOR * tasks[i].period);
 
 	min_deadline = tasks[i].wcet + tasks[i].cleanup;
-        max_deadline = min_deadline + (DEADLINE_FACTOR * (tasks[i].period - min_deadline));
-        std::uniform_real_distribution<double> dist(min_deadline, max_deadline);
-
-        double random_number = dist(gen);
+        max_deadline = min_deadline + (deadline_factor * (tasks[i].period - min_deadline));
+        double random_number = ctx.uniform(min_deadline, max_deadline);
 	tasks[i].deadline = random_number;
 	assert(tasks[i].deadline >= min_deadline && tasks[i].deadline < max_deadline);
     }
 }
 
 
-// Driver function to generate task parameters
-std::vector<Tasks> generate_tasks() {
-    std::vector<Tasks> tasks(NUM_TASKS);
+// Driver function to generate task parameters into 'tasks', reusing its storage
+void generate_tasks(GeneratorContext& ctx, std::vector<Tasks>& tasks) {
+    generate_tasks(ctx, GeneratorParams(), tasks);
+}
+
+// Driver function to generate task parameters of one experiment point
+void generate_tasks(GeneratorContext& ctx, const GeneratorParams& params, std::vector<Tasks>& tasks) {
+    UtilizationSampler sampler;
+    generate_tasks(ctx, params, sampler, tasks);
+}
+
+// Driver function to generate task parameters of one experiment point with a reusable sampler
+void generate_tasks(GeneratorContext& ctx, const GeneratorParams& params, UtilizationSampler& sampler, std::vector<Tasks>& tasks) {
+    assert(params.num_tasks >= 1 && params.num_phases >= 1 && params.num_phases <= MAX_PHASES);
+    INSTRUMENT_SCOPE(STAGE_GENERATE);
+    tasks.assign(params.num_tasks, Tasks());
  
     // Generate task parameters
-    generate_task_utilizations(tasks, MAX_UTILIZATION);
-    generate_task_periods(tasks);
-    generate_task_wcets(tasks);
-    generate_task_deadlines(tasks);
+    if (params.utilization_algorithm == UTIL_UUNIFAST_ROUNDED) {
+        generate_task_utilizations(tasks, params.max_utilization, ctx);
+    } else {
+        generate_task_utilizations(tasks, params.max_utilization, params.utilization_algorithm, sampler, ctx);
+    }
+    generate_task_periods(tasks, params.min_period, params.max_period, ctx);
+    generate_task_wcets(tasks, params.trust_probability, params.q_fraction, ctx);
+    generate_task_deadlines(tasks, params.deadline_factor, ctx);
+    for (Tasks& task : tasks) {
+        task.phases = params.num_phases;
+    }
+}
+
+// Driver function that also archives the generated task set
+bool generate_tasks(GeneratorContext& ctx, const GeneratorParams& params, std::vector<Tasks>& tasks, TasksetWriter& writer) {
+    generate_tasks(ctx, params, tasks);
+    return writer.write(tasks);
+}
 
+// Driver function to generate task parameters from the given generator context
+std::vector<Tasks> generate_tasks(GeneratorContext& ctx) {
+    std::vector<Tasks> tasks;
+    generate_tasks(ctx, tasks);
     return tasks;
 }
 
+// Driver function to generate task parameters from a non-deterministic seed
+std::vector<Tasks> generate_tasks() {
+    GeneratorContext ctx;
+    return generate_tasks(ctx);
+}
+
+// Rounds every parameter towards the pessimistic side of the tick grid
+
+static Ticks ticks_down(double time, Ticks ticks_per_unit) {
+    return Ticks(std::floor(time * ticks_per_unit));
+}
+
+static Ticks ticks_up(double time, Ticks ticks_per_unit) {
+    return Ticks(std::ceil(time * ticks_per_unit));
+}
+
+void convert_to_ticks(const std::vector<Tasks>& tasks, Ticks ticks_per_unit, std::vector<TickTask>& tick_tasks) {
+    tick_tasks.assign(tasks.size(), TickTask());
+    for (std::size_t i = 0; i < tasks.size(); i++) {
+        TickTask& tick_task = tick_tasks[i];
+        tick_task.id = tasks[i].id;
+        tick_task.period = ticks_down(tasks[i].period, ticks_per_unit);
+        tick_task.deadline = ticks_down(tasks[i].deadline, ticks_per_unit);
+        tick_task.wcet = ticks_up(tasks[i].wcet, ticks_per_unit);
+        tick_task.cleanup = ticks_up(tasks[i].cleanup, ticks_per_unit);
+        tick_task.phases = tasks[i].phases;
+        tick_task.uniform_phases = tasks[i].uniform_phases;
+        for (int j = 0; j < MAX_PHASES; j++) {
+            tick_task.phase_wcets[j] = ticks_up(tasks[i].phase_wcets[j], ticks_per_unit);
+            tick_task.phase_cleanups[j] = ticks_up(tasks[i].phase_cleanups[j], ticks_per_unit);
+        }
+    }
+}
+
+void generate_tick_tasks(GeneratorContext& ctx, std::vector<Tasks>& tasks, std::vector<TickTask>& tick_tasks, Ticks ticks_per_unit) {
+    generate_tasks(ctx, tasks);
+    convert_to_ticks(tasks, ticks_per_unit, tick_tasks);
+}
+
 // int main() {
 
 //     // Generate number of phases
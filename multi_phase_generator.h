@@ -3,6 +3,9 @@
 
 #include <vector>
 #include "multi_phase_tasks.h"
+#include "generator_context.h"
+#include "multi_phase_utilization.h"
+#include "multi_phase_corpus.h"
 
 // =================
 // MACRO DEFINITIONS
@@ -11,9 +14,6 @@
 // Task set utilization bound
 #define MAX_UTILIZATION 0.75
 
-// Maximum number of phases
-#define MAX_PHASES 7
-
 // Default value for trust probability 
 #define TRUST_PROBABILITY 0.50
 #define Q_FRACTION 0.25
@@ -30,24 +30,77 @@
 // Deadline factor
 #define DEADLINE_FACTOR 1.0
 
+// Clock ticks per time unit of the integer-tick generator mode
+#define TICKS_PER_UNIT 1000
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Generator parameters of one experiment point. The defaults are the macros above, so a
+// default-constructed GeneratorParams reproduces the compile-time configuration.
+typedef struct GeneratorParams {
+    int num_tasks = NUM_TASKS;
+    int num_phases = NUM_PHASES;                    // Phases of every generated task, at most MAX_PHASES
+    double max_utilization = MAX_UTILIZATION;
+    double min_period = MIN_PERIOD;
+    double max_period = MAX_PERIOD;
+    double trust_probability = TRUST_PROBABILITY;
+    double q_fraction = Q_FRACTION;
+    double deadline_factor = DEADLINE_FACTOR;
+    UtilizationAlgorithm utilization_algorithm = UTILIZATION_ALGORITHM;    // Totals >= 1 need UUniFast-Discard or RandFixedSum
+} GeneratorParams;
+
 // =====================
 // FUNCTION DECLARATIONS
 // =====================
 
 // Task utilizations (Ui = Ci / Ti) are generated using UUnifast [1] providing an unbiased distribution
-void generate_task_utilizations(std::vector<Tasks>& tasks, double max_util);
+void generate_task_utilizations(std::vector<Tasks>& tasks, double max_util, GeneratorContext& ctx);
+
+// Same with an algorithm of multi_phase_utilization.h (no rounding; totals >= 1 for UUniFast-Discard and RandFixedSum)
+void generate_task_utilizations(std::vector<Tasks>& tasks, double total_util, UtilizationAlgorithm algorithm,
+                                UtilizationSampler& sampler, GeneratorContext& ctx);
 
 // Task periods Ti were generated according to a log-uniform distribution [2]
-void generate_task_periods(std::vector<Tasks>& tasks);
+void generate_task_periods(std::vector<Tasks>& tasks, GeneratorContext& ctx);
+void generate_task_periods(std::vector<Tasks>& tasks, double min_period, double max_period, GeneratorContext& ctx);
 
 // Task deadlines are generated according to a log-uniform distribution [2] in the range [0.25, 4.0]Ti
-void generate_task_deadlines(std::vector<Tasks>& tasks);
+void generate_task_deadlines(std::vector<Tasks>& tasks, GeneratorContext& ctx);
+void generate_task_deadlines(std::vector<Tasks>& tasks, double deadline_factor, GeneratorContext& ctx);
 
 // The worst-case execution time of each task is given by Ci = Ui · Ti
-void generate_task_wcets(std::vector<Tasks>& tasks);
+void generate_task_wcets(std::vector<Tasks>& tasks, GeneratorContext& ctx);
+void generate_task_wcets(std::vector<Tasks>& tasks, double trust_probability, double q_fraction, GeneratorContext& ctx);
 
+// Generates one task set; the context overload is reproducible, the other draws its seed from std::random_device
+std::vector<Tasks> generate_tasks(GeneratorContext& ctx);
 std::vector<Tasks> generate_tasks();
 
+// Generates one task set into 'tasks' without allocating once its capacity reaches NUM_TASKS
+void generate_tasks(GeneratorContext& ctx, std::vector<Tasks>& tasks);
+
+// Same for the runtime parameters of one experiment point (capacity params.num_tasks)
+void generate_tasks(GeneratorContext& ctx, const GeneratorParams& params, std::vector<Tasks>& tasks);
+
+// Same, drawing the utilizations from a sampler the caller keeps across task sets (the overload
+// above prepares a temporary one for every task set unless the algorithm is UTIL_UUNIFAST_ROUNDED)
+void generate_tasks(GeneratorContext& ctx, const GeneratorParams& params, UtilizationSampler& sampler, std::vector<Tasks>& tasks);
+
+// Same, and streams the task set to a corpus; false if the write failed
+bool generate_tasks(GeneratorContext& ctx, const GeneratorParams& params, std::vector<Tasks>& tasks, TasksetWriter& writer);
+
+// Converts a task set to integer clock ticks. Periods and deadlines are rounded down and execution
+// and clean up costs up, so the demand of the tick task set is never below the original one. The
+// analysis of the tick task set is exact, but beta is bounded by the points on the tick grid, so its
+// verdict can differ from the double analysis of the unrounded task set.
+void convert_to_ticks(const std::vector<Tasks>& tasks, Ticks ticks_per_unit, std::vector<TickTask>& tick_tasks);
+
+// Integer-tick generator mode: generates one task set into 'tasks' and its tick version into 'tick_tasks'
+void generate_tick_tasks(GeneratorContext& ctx, std::vector<Tasks>& tasks, std::vector<TickTask>& tick_tasks,
+                         Ticks ticks_per_unit = TICKS_PER_UNIT);
+
 // Task parameter generator driver function
 // Tasks* task_parameter_generator (Tasks *tasks, int num_tasks, double total_util);
 
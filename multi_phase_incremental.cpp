@@ -0,0 +1,254 @@
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include "multi_phase_incremental.h"
+
+// Demand of a single task at td (zero before its first deadline, as in compute_max_blocking)
+
+static double task_dbf(const Tasks& task, int td) {
+    return task.deadline <= td ? compute_dbf(task, td) : 0.0;
+}
+
+// Appends every job deadline point ceil(k*T + D) of 'task' in (from, to], duplicates included
+
+static void append_task_points(const Tasks& task, int from, int to, std::vector<int>& points) {
+    long long job = 0;
+    if (task.deadline <= from) {
+        job = (long long)(std::floor((from - task.deadline) / task.period)) + 1;
+    }
+    for (;; job++) {
+        double point = std::ceil(job * task.period + task.deadline);
+        if (point > to) {
+            break;
+        }
+        points.push_back(std::max(int(point), from + 1));
+    }
+}
+
+// Beta of a task given the minimum slack before its deadline; false if some phase no longer fits
+
+static bool task_beta_feasible(const Tasks& task, bool has_point, double min_delta, double* beta) {
+    double task_beta = 0.0;
+    for (int j = 0; j < task.phases; j++) {
+        task_beta = std::max(task_beta, task_phase_wcet(task, j) + task_phase_cleanup(task, j));
+    }
+    if (has_point && task_beta - 1 > min_delta) {
+        task_beta = min_delta + 1;
+    }
+    if (beta != nullptr) {
+        *beta = task_beta;
+    }
+    if (!has_point) {
+        return true; // No deadline point precedes Di, so the analysis never constrains this task
+    }
+    for (int j = 0; j < task.phases; j++) {
+        if (!(task_beta > task_phase_cleanup(task, j))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+IncrementalAnalyzer::IncrementalAnalyzer(TestingBound bound) : bound_(bound) {
+}
+
+// Minimum slack over the points strictly before 'deadline'. Points from index first_staged of the
+// staged list on replace the stored ones; earlier points are read from the map.
+
+double IncrementalAnalyzer::min_delta_before(double deadline, const std::vector<StagedPoint>& staged, int first_staged, bool* found) const {
+
+    int limit = int(std::ceil(deadline)); // td < Di  <=>  td < ceil(Di) for integer td
+
+    if (first_staged < static_cast<int>(staged.size()) && staged[first_staged].point < limit) {
+        auto it = std::lower_bound(staged.begin() + first_staged, staged.end(), limit,
+                                   [](const StagedPoint& p, int key) { return p.point < key; });
+        *found = true;
+        return (it - 1)->prefix_min;
+    }
+
+    auto it = points_.lower_bound(limit);
+    if (it == points_.begin()) {
+        *found = false;
+        return 0.0;
+    }
+    *found = true;
+    return std::prev(it)->second.prefix_min;
+}
+
+// Demand condition beyond the beta window, exactly as analyze_taskset() checks it
+
+bool IncrementalAnalyzer::tail_demand_ok(int window) {
+    return demand_test_beyond_window(taskset_, window, bound_, scratch_);
+}
+
+void IncrementalAnalyzer::refresh_prefix_min(std::map<int, DemandPoint>::iterator from) {
+    double prefix_min = std::numeric_limits<double>::infinity();
+    if (from != points_.begin()) {
+        prefix_min = std::prev(from)->second.prefix_min;
+    }
+    for (auto it = from; it != points_.end(); ++it) {
+        prefix_min = std::min(prefix_min, it->first - it->second.demand);
+        it->second.prefix_min = prefix_min;
+    }
+}
+
+bool IncrementalAnalyzer::try_admit(const Tasks& task) {
+
+    assert(tasks_.count(task.id) == 0 && task.phases >= 1 && task.phases <= MAX_PHASES);
+
+    int new_window = std::max(window_, int(task.deadline));
+    std::size_t slot = taskset_append(taskset_, task);
+
+    // Deadline points that are new: the jobs of 'task', and every job entering a wider window
+    new_points_.clear();
+    append_task_points(task, 0, new_window, new_points_);
+    if (new_window > window_) {
+        for (const auto& entry : tasks_) {
+            append_task_points(entry.second, window_, new_window, new_points_);
+        }
+    }
+    std::sort(new_points_.begin(), new_points_.end());
+
+    // First point whose demand or membership changes; nothing before it is touched
+    int first_changed = std::numeric_limits<int>::max();
+    auto first_existing = points_.upper_bound(int(std::floor(task.deadline)));
+    if (first_existing != points_.end()) {
+        first_changed = first_existing->first;
+    }
+    if (!new_points_.empty()) {
+        first_changed = std::min(first_changed, new_points_.front());
+    }
+
+    // Merge the stored points from first_changed on with the new ones and recompute their slack
+    staged_.clear();
+    double prefix_min = std::numeric_limits<double>::infinity();
+    auto it = points_.lower_bound(first_changed);
+    if (it != points_.begin()) {
+        prefix_min = std::prev(it)->second.prefix_min;
+    }
+    std::size_t k = 0;
+    while (it != points_.end() || k < new_points_.size()) {
+        StagedPoint staged;
+        if (k == new_points_.size() || (it != points_.end() && it->first <= new_points_[k])) {
+            staged.point = it->first;
+            staged.demand = it->second.demand + task_dbf(task, it->first);
+            staged.refs = it->second.refs;
+            ++it;
+        } else {
+            staged.point = new_points_[k];
+            staged.demand = taskset_dbf(taskset_, staged.point);
+            staged.refs = 0;
+        }
+        while (k < new_points_.size() && new_points_[k] == staged.point) {
+            staged.refs++;
+            k++;
+        }
+        prefix_min = std::min(prefix_min, staged.point - staged.demand);
+        staged.prefix_min = prefix_min;
+        staged_.push_back(staged);
+    }
+
+    bool schedulable = staged_.empty() || staged_.back().prefix_min >= 0;
+
+    // Only tasks with a deadline after first_changed see different slack
+    if (schedulable) {
+        bool found = false;
+        double min_delta = min_delta_before(task.deadline, staged_, 0, &found);
+        schedulable = task_beta_feasible(task, found, min_delta, nullptr);
+    }
+    for (auto entry = by_deadline_.upper_bound(first_changed); schedulable && entry != by_deadline_.end(); ++entry) {
+        bool found = false;
+        double min_delta = min_delta_before(entry->first, staged_, 0, &found);
+        schedulable = task_beta_feasible(tasks_.at(entry->second), found, min_delta, nullptr);
+    }
+
+    if (schedulable && bound_ != BOUND_MAX_DEADLINE) {
+        schedulable = tail_demand_ok(new_window);
+    }
+
+    if (!schedulable) {
+        taskset_remove(taskset_, slot);
+        return false;
+    }
+
+    // Commit
+    tasks_[task.id] = task;
+    slot_of_[task.id] = slot;
+    id_of_slot_.push_back(task.id);
+    by_deadline_.insert(std::make_pair(task.deadline, task.id));
+    for (const StagedPoint& staged : staged_) {
+        DemandPoint& point = points_[staged.point];
+        point.demand = staged.demand;
+        point.prefix_min = staged.prefix_min;
+        point.refs = staged.refs;
+    }
+    window_ = new_window;
+    return true;
+}
+
+bool IncrementalAnalyzer::remove(int task_id) {
+
+    auto found = tasks_.find(task_id);
+    if (found == tasks_.end()) {
+        return false;
+    }
+    Tasks task = found->second;
+
+    // Keep the SoA slots dense: the last task moves into the freed slot
+    std::size_t slot = slot_of_[task_id];
+    std::size_t last = id_of_slot_.size() - 1;
+    taskset_remove(taskset_, slot);
+    if (slot != last) {
+        id_of_slot_[slot] = id_of_slot_[last];
+        slot_of_[id_of_slot_[slot]] = slot;
+    }
+    id_of_slot_.pop_back();
+    slot_of_.erase(task_id);
+    tasks_.erase(found);
+    for (auto entry = by_deadline_.lower_bound(task.deadline); entry != by_deadline_.end(); ++entry) {
+        if (entry->second == task_id) {
+            by_deadline_.erase(entry);
+            break;
+        }
+    }
+
+    int new_window = by_deadline_.empty() ? 0 : int(std::prev(by_deadline_.end())->first);
+
+    // Drop the task's own job deadlines, then everything that left the window, then its demand
+    new_points_.clear();
+    append_task_points(task, 0, window_, new_points_);
+    for (int point : new_points_) {
+        auto it = points_.find(point);
+        if (it != points_.end() && --it->second.refs == 0) {
+            points_.erase(it);
+        }
+    }
+    points_.erase(points_.upper_bound(new_window), points_.end());
+    for (auto it = points_.upper_bound(int(std::floor(task.deadline))); it != points_.end(); ++it) {
+        it->second.demand -= task_dbf(task, it->first);
+    }
+    refresh_prefix_min(points_.lower_bound(int(std::floor(task.deadline))));
+
+    window_ = new_window;
+    return true;
+}
+
+std::vector<Tasks> IncrementalAnalyzer::tasks() const {
+    std::vector<Tasks> admitted;
+    for (int id : id_of_slot_) {
+        admitted.push_back(tasks_.at(id));
+    }
+    return admitted;
+}
+
+double IncrementalAnalyzer::beta(int task_id) const {
+    const Tasks& task = tasks_.at(task_id);
+    bool found = false;
+    double min_delta = min_delta_before(task.deadline, staged_, static_cast<int>(staged_.size()), &found);
+    double task_beta = 0.0;
+    task_beta_feasible(task, found, min_delta, &task_beta);
+    return task_beta;
+}
@@ -0,0 +1,79 @@
+#ifndef MULTI_PHASE_INCREMENTAL_H
+#define MULTI_PHASE_INCREMENTAL_H
+
+#include <cstddef>
+#include <map>
+#include <vector>
+#include "multi-phase.h"
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Demand of the admitted task set at one deadline point
+typedef struct DemandPoint {
+    double demand = 0.0;        // dbf(td)
+    double prefix_min = 0.0;    // Minimum of td' - dbf(td') over all points td' <= td
+    int refs = 0;               // Number of job deadlines that map to this point
+} DemandPoint;
+
+// Online admission controller running the multi-phase test incrementally. It keeps the deadline
+// points up to max(D_i) with their demand, and the SoA task set used for the dbf beyond that window.
+// A decision is the one analyze_taskset() would reach on the resulting task set (up to the order in
+// which floating-point demands are summed).
+//
+// Only the window is incremental. With n admitted tasks, P stored points, P' of them at or after the
+// changed task's first deadline, J its jobs in the window and W the job deadlines that enter the window:
+//  - try_admit() costs O(n + (J + W) * n + P' log P) for the window: every task is scanned for points
+//    entering a wider window, new points get a full dbf, stored points from the first change on are
+//    re-merged, and the tasks with a deadline after it are re-checked. It then re-runs the whole
+//    demand check beyond max(D_i) on all n tasks, O(n) per point it visits: few under QPA, every
+//    deadline point up to the bound under BOUND_BUSY_PERIOD and BOUND_LA_LB. Nothing of that check
+//    is kept between calls.
+//  - remove() costs O(J log P + P'), mostly refreshing the prefix minima after the task's deadline.
+// A task with an early deadline therefore touches nearly every stored point.
+class IncrementalAnalyzer {
+public:
+    explicit IncrementalAnalyzer(TestingBound bound = DEFAULT_TESTING_BOUND);
+
+    // Admits 'task' if the task set stays schedulable with it; task.id must not be admitted already
+    bool try_admit(const Tasks& task);
+
+    // Removes an admitted task (removing demand never breaks schedulability); false if unknown
+    bool remove(int task_id);
+
+    std::size_t size() const { return tasks_.size(); }
+    std::size_t num_deadline_points() const { return points_.size(); }
+
+    // Admitted tasks in admission-slot order (the order analyze_taskset() would see them in)
+    std::vector<Tasks> tasks() const;
+
+    // Current beta of an admitted task
+    double beta(int task_id) const;
+
+private:
+    typedef struct StagedPoint {
+        int point;
+        double demand;
+        double prefix_min;
+        int refs;
+    } StagedPoint;
+
+    double min_delta_before(double deadline, const std::vector<StagedPoint>& staged, int first_staged, bool* found) const;
+    bool tail_demand_ok(int window);
+    void refresh_prefix_min(std::map<int, DemandPoint>::iterator from);
+
+    TestingBound bound_;
+    int window_ = 0;                                // int(max D_i), the last point that bounds beta
+    std::map<int, Tasks> tasks_;                    // Admitted tasks by id
+    std::map<int, std::size_t> slot_of_;            // Task id -> slot in taskset_
+    std::vector<int> id_of_slot_;
+    std::multimap<double, int> by_deadline_;        // Di -> task id
+    std::map<int, DemandPoint> points_;             // Deadline points in (0, window_]
+    TaskSet taskset_;
+    std::vector<int> new_points_;                   // Scratch
+    std::vector<StagedPoint> staged_;               // Scratch
+    AnalysisScratch scratch_;                       // Scratch for the demand check beyond the window
+};
+
+#endif
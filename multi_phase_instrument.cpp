@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "multi_phase_instrument.h"
+
+thread_local InstrumentCounters* instrument_thread_counters = nullptr;
+
+// Counters of the threads that are still running and the sum of those that have exited
+typedef struct InstrumentRegistry {
+    std::mutex mutex;
+    std::vector<InstrumentCounters*> live;
+    InstrumentCounters retired;
+} InstrumentRegistry;
+
+static InstrumentRegistry& instrument_registry() {
+    static InstrumentRegistry* registry = new InstrumentRegistry(); // Never destroyed, so threads may exit after main()
+    return *registry;
+}
+
+// Owns the counters of one thread and folds them into the retired total when the thread exits
+class InstrumentThread {
+public:
+    InstrumentThread() {
+        InstrumentRegistry& registry = instrument_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.live.push_back(&counters_);
+    }
+
+    ~InstrumentThread() {
+        InstrumentRegistry& registry = instrument_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        add_instrument_counters(registry.retired, counters_);
+        registry.live.erase(std::find(registry.live.begin(), registry.live.end(), &counters_));
+        instrument_thread_counters = nullptr;
+    }
+
+    InstrumentCounters& counters() { return counters_; }
+
+private:
+    InstrumentCounters counters_;
+};
+
+InstrumentCounters& instrument_register_thread() {
+    static thread_local InstrumentThread thread;
+    instrument_thread_counters = &thread.counters();
+    return thread.counters();
+}
+
+void add_instrument_counters(InstrumentCounters& into, const InstrumentCounters& from) {
+    for (int c = 0; c < INSTRUMENT_NUM_COUNTERS; c++) {
+        into.counters[c] += from.counters[c];
+    }
+    for (int s = 0; s < INSTRUMENT_NUM_STAGES; s++) {
+        LatencyHistogram& to = into.stages[s];
+        const LatencyHistogram& histogram = from.stages[s];
+        to.count += histogram.count;
+        to.total += histogram.total;
+        to.min = std::min(to.min, histogram.min);
+        to.max = std::max(to.max, histogram.max);
+        for (int b = 0; b < INSTRUMENT_HISTOGRAM_BUCKETS; b++) {
+            to.buckets[b] += histogram.buckets[b];
+        }
+    }
+}
+
+void instrument_snapshot(InstrumentCounters& total) {
+    InstrumentRegistry& registry = instrument_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    total = registry.retired;
+    for (const InstrumentCounters* counters : registry.live) {
+        add_instrument_counters(total, *counters);
+    }
+}
+
+void instrument_reset() {
+    InstrumentRegistry& registry = instrument_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired = InstrumentCounters();
+    for (InstrumentCounters* counters : registry.live) {
+        *counters = InstrumentCounters();
+    }
+}
+
+uint64_t latency_bucket_floor(int bucket) {
+    const int sub_bits = INSTRUMENT_SUB_BUCKET_BITS;
+    if (bucket < (1 << sub_bits)) {
+        return uint64_t(bucket);
+    }
+    int group = bucket >> sub_bits;
+    uint64_t mantissa = (uint64_t(1) << sub_bits) + uint64_t(bucket & ((1 << sub_bits) - 1));
+    return mantissa << (group - 1);
+}
+
+uint64_t latency_quantile(const LatencyHistogram& histogram, double q) {
+    if (histogram.count == 0) {
+        return 0;
+    }
+    long long rank = std::max(1LL, (long long)(q * histogram.count + 0.5));
+    long long seen = 0;
+    for (int b = 0; b < INSTRUMENT_HISTOGRAM_BUCKETS; b++) {
+        seen += histogram.buckets[b];
+        if (seen >= rank) {
+            return std::max(latency_bucket_floor(b), histogram.min);
+        }
+    }
+    return histogram.max;
+}
+
+// Clock reading at static initialization, so that the rate is measured over the whole run
+
+typedef struct ClockEpoch {
+    uint64_t ticks = instrument_clock();
+    std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+} ClockEpoch;
+
+static const ClockEpoch clock_epoch;
+
+double instrument_clock_rate() {
+#if !defined(__x86_64__) && !defined(__i386__)
+    return 1e9;
+#else
+    // At least 10 ms between the two readings, so that the rate is accurate to well below 1%
+    std::chrono::steady_clock::time_point earliest = clock_epoch.time + std::chrono::milliseconds(10);
+    if (std::chrono::steady_clock::now() < earliest) {
+        std::this_thread::sleep_until(earliest);
+    }
+    uint64_t ticks = instrument_clock();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - clock_epoch.time).count();
+    return double(ticks - clock_epoch.ticks) / seconds;
+#endif
+}
+
+void write_instrument_report(std::ostream& out) {
+
+    InstrumentCounters total;
+    instrument_snapshot(total);
+#if defined(__x86_64__) || defined(__i386__)
+    const char* clock = "tsc";
+#else
+    const char* clock = "steady_clock_ns";
+#endif
+
+    out << "{\n  \"enabled\": " << (MULTI_PHASE_INSTRUMENT ? "true" : "false") << ",\n  \"clock\": \"" << clock
+        << "\",\n  \"ticks_per_second\": " << instrument_clock_rate() << ",\n  \"counters\": {";
+    for (int c = 0; c < INSTRUMENT_NUM_COUNTERS; c++) {
+        out << (c == 0 ? "" : ", ") << "\"" << instrument_counter_name(InstrumentCounter(c)) << "\": " << total.counters[c];
+    }
+    out << "},\n  \"stages\": {\n";
+    for (int s = 0; s < INSTRUMENT_NUM_STAGES; s++) {
+        const LatencyHistogram& histogram = total.stages[s];
+        out << "    \"" << instrument_stage_name(InstrumentStage(s)) << "\": {\"count\": " << histogram.count
+            << ", \"total_ticks\": " << histogram.total
+            << ", \"mean_ticks\": " << (histogram.count > 0 ? double(histogram.total) / histogram.count : 0.0)
+            << ", \"min_ticks\": " << (histogram.count > 0 ? histogram.min : 0) << ", \"max_ticks\": " << histogram.max
+            << ", \"p50_ticks\": " << latency_quantile(histogram, 0.5) << ", \"p90_ticks\": " << latency_quantile(histogram, 0.9)
+            << ", \"p99_ticks\": " << latency_quantile(histogram, 0.99) << ", \"buckets\": [";
+        bool first = true;
+        for (int b = 0; b < INSTRUMENT_HISTOGRAM_BUCKETS; b++) {
+            if (histogram.buckets[b] > 0) {
+                out << (first ? "" : ", ") << "[" << latency_bucket_floor(b) << ", " << histogram.buckets[b] << "]";
+                first = false;
+            }
+        }
+        out << "]}" << (s + 1 < INSTRUMENT_NUM_STAGES ? "," : "") << "\n";
+    }
+    out << "  }\n}\n";
+}
+
+const char* instrument_counter_name(InstrumentCounter counter) {
+    switch (counter) {
+        case COUNTER_TASKSETS:
+            return "tasksets";
+        case COUNTER_DEADLINE_POINTS:
+            return "deadline_points";
+        case COUNTER_DBF_EVALUATIONS:
+            return "dbf_evaluations";
+        case COUNTER_CHUNK_SEARCH_STEPS:
+            return "chunk_search_steps";
+        case COUNTER_CHUNK_SKIPS:
+            return "chunk_skips";
+        case COUNTER_ALLOCATIONS:
+            return "allocations";
+        case COUNTER_EARLY_EXITS:
+            return "early_exits";
+        case INSTRUMENT_NUM_COUNTERS:
+            break;
+    }
+    return "unknown";
+}
+
+const char* instrument_stage_name(InstrumentStage stage) {
+    switch (stage) {
+        case STAGE_GENERATE:
+            return "generate";
+        case STAGE_PREFILTER:
+            return "prefilter";
+        case STAGE_EXACT:
+            return "exact";
+        case STAGE_DEADLINE_LOOP:
+            return "deadline_loop";
+        case STAGE_CHUNK_SEARCH:
+            return "chunk_search";
+        case STAGE_BEYOND_WINDOW:
+            return "beyond_window";
+        case INSTRUMENT_NUM_STAGES:
+            break;
+    }
+    return "unknown";
+}
@@ -0,0 +1,171 @@
+#ifndef MULTI_PHASE_INSTRUMENT_H
+#define MULTI_PHASE_INSTRUMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Hot-path instrumentation of the analysis engine: per-thread event counters and per-stage latency
+// histograms. It is compiled out unless the build defines MULTI_PHASE_INSTRUMENT=1; the
+// INSTRUMENT_COUNT and INSTRUMENT_SCOPE macros then expand to nothing, so default builds run the
+// same code as before. When enabled, every thread adds to its own cache-line aligned block without
+// synchronization; a thread's block is folded into a process-wide total when the thread exits, and
+// instrument_snapshot() adds the blocks of the threads still running.
+//
+// Stages are timed with the time-stamp counter (steady_clock nanoseconds where there is none).
+// Stages nest: the chunk search is part of the deadline loop, which is part of the exact analysis.
+// Latencies go into log-linear histograms: exact below 2^INSTRUMENT_SUB_BUCKET_BITS, then
+// 2^INSTRUMENT_SUB_BUCKET_BITS equal buckets per power of two, so any latency is resolved to within
+// 1 / 2^INSTRUMENT_SUB_BUCKET_BITS of its value.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+#ifndef MULTI_PHASE_INSTRUMENT
+#define MULTI_PHASE_INSTRUMENT 0
+#endif
+
+// Linear buckets per power of two of the latency histograms
+#define INSTRUMENT_SUB_BUCKET_BITS 3
+#define INSTRUMENT_HISTOGRAM_BUCKETS ((64 - INSTRUMENT_SUB_BUCKET_BITS + 1) << INSTRUMENT_SUB_BUCKET_BITS)
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef enum {
+    COUNTER_TASKSETS,               // Exact analyses run (task sets the pre-filters did not decide)
+    COUNTER_DEADLINE_POINTS,        // Deadline points visited, in the window and beyond it
+    COUNTER_DBF_EVALUATIONS,        // Task set dbf evaluations at one point
+    COUNTER_CHUNK_SEARCH_STEPS,     // Chunk counts tried by compute_min_chunks()
+    COUNTER_CHUNK_SKIPS,            // Chunk searches skipped because beta did not change
+    COUNTER_ALLOCATIONS,            // Analysis scratch buffers that had to grow
+    COUNTER_EARLY_EXITS,            // Exact analyses that failed at a deadline point in the window
+    INSTRUMENT_NUM_COUNTERS
+} InstrumentCounter;
+
+typedef enum {
+    STAGE_GENERATE,                 // Generating one task set
+    STAGE_PREFILTER,                // The pre-filters of the tiered analysis
+    STAGE_EXACT,                    // One exact analysis
+    STAGE_DEADLINE_LOOP,            // Its loop over the deadline points in the window
+    STAGE_CHUNK_SEARCH,             // The chunk counts of one task after its beta changed
+    STAGE_BEYOND_WINDOW,            // The demand check beyond the window
+    INSTRUMENT_NUM_STAGES
+} InstrumentStage;
+
+typedef struct LatencyHistogram {
+    long long count = 0;
+    uint64_t total = 0;             // Clock ticks
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+    long long buckets[INSTRUMENT_HISTOGRAM_BUCKETS] = {};
+} LatencyHistogram;
+
+typedef struct alignas(64) InstrumentCounters {
+    long long counters[INSTRUMENT_NUM_COUNTERS] = {};
+    LatencyHistogram stages[INSTRUMENT_NUM_STAGES];
+} InstrumentCounters;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Counters of the calling thread, registered on first use
+InstrumentCounters& instrument_register_thread();
+
+// Sum of the counters of all threads, running or finished
+void instrument_snapshot(InstrumentCounters& total);
+
+// Clears the counters of all threads; only call while no other thread is instrumenting
+void instrument_reset();
+
+// Adds 'from' to 'into'
+void add_instrument_counters(InstrumentCounters& into, const InstrumentCounters& from);
+
+// Smallest latency of a histogram bucket
+uint64_t latency_bucket_floor(int bucket);
+
+// Smallest latency at or above which a fraction 1 - q of the recorded latencies lie (bucket resolution)
+uint64_t latency_quantile(const LatencyHistogram& histogram, double q);
+
+// Clock ticks per second of instrument_clock(), measured against steady_clock
+double instrument_clock_rate();
+
+// Counters and histograms of instrument_snapshot() as one JSON object; non-empty buckets only
+void write_instrument_report(std::ostream& out);
+
+// Name of a counter or stage, e.g. "deadline_points"
+const char* instrument_counter_name(InstrumentCounter counter);
+const char* instrument_stage_name(InstrumentStage stage);
+
+// ====================
+// INLINE DEFINITIONS
+// ====================
+
+// Counters of the calling thread once it is registered
+extern thread_local InstrumentCounters* instrument_thread_counters;
+
+inline InstrumentCounters& instrument_counters() {
+    InstrumentCounters* counters = instrument_thread_counters;
+    return counters != nullptr ? *counters : instrument_register_thread();
+}
+
+inline uint64_t instrument_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Histogram bucket of a latency: the latency itself below 2^INSTRUMENT_SUB_BUCKET_BITS, then the
+// power of two and the next INSTRUMENT_SUB_BUCKET_BITS bits below the leading one
+inline int latency_bucket(uint64_t ticks) {
+    const int sub_bits = INSTRUMENT_SUB_BUCKET_BITS;
+    if (ticks < (uint64_t(1) << sub_bits)) {
+        return int(ticks);
+    }
+    int exponent = 63 - __builtin_clzll(ticks);
+    return ((exponent - sub_bits + 1) << sub_bits) + int((ticks >> (exponent - sub_bits)) & ((1u << sub_bits) - 1));
+}
+
+inline void record_latency(LatencyHistogram& histogram, uint64_t ticks) {
+    histogram.count++;
+    histogram.total += ticks;
+    histogram.min = ticks < histogram.min ? ticks : histogram.min;
+    histogram.max = ticks > histogram.max ? ticks : histogram.max;
+    histogram.buckets[latency_bucket(ticks)]++;
+}
+
+// Records the clock ticks from construction to destruction into the histogram of one stage
+class InstrumentTimer {
+public:
+    explicit InstrumentTimer(InstrumentStage stage) : stage_(stage), start_(instrument_clock()) {}
+    ~InstrumentTimer() { record_latency(instrument_counters().stages[stage_], instrument_clock() - start_); }
+    InstrumentTimer(const InstrumentTimer&) = delete;
+    InstrumentTimer& operator=(const InstrumentTimer&) = delete;
+
+private:
+    InstrumentStage stage_;
+    uint64_t start_;
+};
+
+#if MULTI_PHASE_INSTRUMENT
+#define INSTRUMENT_COUNT(counter, n) (instrument_counters().counters[counter] += (long long)(n))
+#define INSTRUMENT_SCOPE_NAME(line) instrument_timer_##line
+#define INSTRUMENT_SCOPE_AT(stage, line) InstrumentTimer INSTRUMENT_SCOPE_NAME(line)(stage)
+#define INSTRUMENT_SCOPE(stage) INSTRUMENT_SCOPE_AT(stage, __LINE__)
+#else
+#define INSTRUMENT_COUNT(counter, n) ((void)0)
+#define INSTRUMENT_SCOPE(stage) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_sweep.h"
+#include "multi_phase_experiment.h"
+#include "multi_phase_instrument.h"
+using namespace std;
+
+// Counters and stage latencies of the whole run, if requested (instrumented builds only)
+static int finish_run(const ExperimentConfig& config, const char* program) {
+    if (config.instrument_path.empty()) {
+        return 0;
+    }
+    ofstream file(config.instrument_path);
+    write_instrument_report(file);
+    if (!file) {
+        cerr << program << ": cannot write '" << config.instrument_path << "'\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+    // Without options: the compile-time configuration, as before
+    if (argc == 1) {
+        // Generate and test the task sets on all cores; every task set is seeded from its index
+        SweepCounters counters = run_taskset_sweep(NUM_TASKSETS, SWEEP_MASTER_SEED, SWEEP_THREADS);
+
+        cout<<"Total scheduled are: "<<counters.total_scheduled<<" Total non-scheduled are: "<<counters.total_non_scheduled<<endl;
+        print_sweep_tiers(cout, counters);
+#if MULTI_PHASE_INSTRUMENT
+        write_instrument_report(cerr);
+#endif
+        return 0;
+    }
+
+    // With options: a whole experiment grid in this process (see multi_phase_experiment.h for the keys)
+    ExperimentConfig config;
+    string error;
+    if (!parse_experiment_args(argc, argv, config, &error)) {
+        cerr << argv[0] << ": " << error << "\n";
+        cerr << "usage: " << argv[0] << " [--config FILE] [--utilizations LIST] [--tasks LIST] [--phases LIST] [--trust LIST]"
+             << " [--tasksets N] [--seed N] [--threads N] [--bound qpa|la_lb|busy_period|max_deadline]"
+             << " [--report none|csv|json] [--bucket_width W] [--trace_every N]"
+             << " [--ci_half_width W] [--confidence C] [--batch N] [--skip_saturated 0|1]"
+             << " [--sensitivity none|taskset|task] [--sensitivity_tolerance T]"
+             << " [--simulate none|taskset|task] [--sim_horizon H] [--instrument FILE] ...\n";
+        return 1;
+    }
+
+    if (config.sensitivity) {
+        write_sensitivity_report(cout, config);
+        return finish_run(config, argv[0]);
+    }
+    if (config.simulate) {
+        write_simulation_report(cout, config);
+        return finish_run(config, argv[0]);
+    }
+
+    // Without a report every point is printed as soon as it completes; with one, everything is written at the end
+    if (config.report.format == REPORT_NONE) {
+        print_experiment_header(cout);
+        run_experiment(config, [](const ExperimentPoint& point) {
+            print_experiment_point(cout, point);
+        });
+        return finish_run(config, argv[0]);
+    }
+
+    vector<ExperimentPoint> points;
+    run_experiment(config, [&points](const ExperimentPoint& point) {
+        points.push_back(point);
+    });
+    write_experiment_report(cout, points, config.report.format);
+    return finish_run(config, argv[0]);
+}
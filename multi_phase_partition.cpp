@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include "multi_phase_partition.h"
+#include "multi_phase_incremental.h"
+#include "work_stealing.h"
+
+double partition_key(const Tasks& task, PartitionOrder order) {
+    switch (order) {
+        case PARTITION_BY_UTILIZATION:
+            return task.wcet / task.period;
+        case PARTITION_BY_DENSITY:
+            return task.wcet / std::min(task.deadline, task.period);
+        case PARTITION_BY_CLEANUP: {
+            double cleanup = 0.0;
+            for (int j = 0; j < task.phases; j++) {
+                cleanup = std::max(cleanup, task_phase_cleanup(task, j));
+            }
+            return cleanup;
+        }
+    }
+    return 0.0;
+}
+
+// One heuristic. Returns false as soon as a task fits nowhere, or once a heuristic ranked before
+// this one ('rank' in the caller's list) has found a partition; *abandoned tells the two apart.
+
+static bool run_heuristic(const std::vector<Tasks>& tasks, int num_cores, PartitionHeuristic heuristic, TestingBound bound,
+                          const std::atomic<int>* winner, int rank, PartitionResult& result, bool* abandoned) {
+
+    const int n = static_cast<int>(tasks.size());
+    result = PartitionResult();
+    result.heuristic = heuristic;
+    result.core_of_task.assign(n, -1);
+    result.core_utilization.assign(num_cores, 0.0);
+    *abandoned = false;
+
+    std::vector<double> keys(n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = partition_key(tasks[i], heuristic.order);
+    }
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) { return keys[a] > keys[b]; });
+
+    std::vector<IncrementalAnalyzer> cores(num_cores, IncrementalAnalyzer(bound));
+    std::vector<int> candidates(num_cores);
+    for (int i : order) {
+        if (winner != nullptr && winner->load(std::memory_order_relaxed) < rank) {
+            *abandoned = true;
+            return false;
+        }
+
+        std::iota(candidates.begin(), candidates.end(), 0);
+        const std::vector<double>& util = result.core_utilization;
+        if (heuristic.fit == PARTITION_BEST_FIT) {
+            std::stable_sort(candidates.begin(), candidates.end(), [&util](int a, int b) { return util[a] > util[b]; });
+        } else if (heuristic.fit == PARTITION_WORST_FIT) {
+            std::stable_sort(candidates.begin(), candidates.end(), [&util](int a, int b) { return util[a] < util[b]; });
+        }
+
+        // The task keeps its index as id on the core, so it can be removed again by the caller's numbering
+        Tasks task = tasks[i];
+        task.id = i;
+        double task_util = task.wcet / task.period;
+        bool empty_rejected = false;
+        for (int core : candidates) {
+            bool empty = cores[core].size() == 0;
+            // Demand utilization above 1 fails the test beyond the window (except for BOUND_MAX_DEADLINE),
+            // and all empty cores decide alike
+            if ((bound != BOUND_MAX_DEADLINE && util[core] + task_util > 1.0) || (empty && empty_rejected)) {
+                continue;
+            }
+            if (cores[core].try_admit(task)) {
+                result.core_of_task[i] = core;
+                result.core_utilization[core] += task_util;
+                break;
+            }
+            empty_rejected = empty_rejected || empty;
+        }
+        if (result.core_of_task[i] < 0) {
+            result.unplaced_task = i;
+            return false;
+        }
+    }
+    result.feasible = true;
+    return true;
+}
+
+std::vector<PartitionHeuristic> partition_heuristics() {
+    std::vector<PartitionHeuristic> heuristics;
+    for (PartitionOrder order : {PARTITION_BY_UTILIZATION, PARTITION_BY_DENSITY, PARTITION_BY_CLEANUP}) {
+        for (PartitionFit fit : {PARTITION_FIRST_FIT, PARTITION_BEST_FIT, PARTITION_WORST_FIT}) {
+            PartitionHeuristic heuristic;
+            heuristic.fit = fit;
+            heuristic.order = order;
+            heuristics.push_back(heuristic);
+        }
+    }
+    return heuristics;
+}
+
+bool partition_with_heuristic(const std::vector<Tasks>& tasks, int num_cores, PartitionHeuristic heuristic,
+                              TestingBound bound, PartitionResult* result) {
+    PartitionResult local;
+    bool abandoned = false;
+    bool feasible = run_heuristic(tasks, num_cores, heuristic, bound, nullptr, 0, local, &abandoned);
+    local.heuristics_tried = 1;
+    if (result != nullptr) {
+        *result = local;
+    }
+    return feasible;
+}
+
+bool partition_tasks(const std::vector<Tasks>& tasks, int num_cores, const PartitionOptions& options, PartitionResult* result) {
+
+    std::vector<PartitionHeuristic> heuristics = options.heuristics.empty() ? partition_heuristics() : options.heuristics;
+    const int count = static_cast<int>(heuristics.size());
+
+    // Rank of the best feasible heuristic so far; heuristics ranked after it stop at their next task
+    std::atomic<int> winner(count);
+    std::atomic<int> tried(0);
+    std::vector<PartitionResult> attempts(count);
+    parallel_for_each_index(count, options.threads, [&](long long index, int) {
+        int rank = static_cast<int>(index);
+        if (winner.load(std::memory_order_relaxed) < rank) {
+            return;
+        }
+        bool abandoned = false;
+        if (!run_heuristic(tasks, num_cores, heuristics[rank], options.bound, &winner, rank, attempts[rank], &abandoned)) {
+            if (!abandoned) {
+                tried.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+        tried.fetch_add(1, std::memory_order_relaxed);
+        int best = winner.load(std::memory_order_relaxed);
+        while (rank < best && !winner.compare_exchange_weak(best, rank, std::memory_order_relaxed)) {
+        }
+    });
+
+    int best = winner.load();
+    bool feasible = best < count;
+    if (result != nullptr) {
+        if (feasible) {
+            *result = attempts[best];
+        } else if (count > 0) {
+            *result = attempts[0];
+        } else {
+            *result = PartitionResult();
+        }
+        result->heuristics_tried = tried.load();
+    }
+    return feasible;
+}
+
+void partition_cores(const std::vector<Tasks>& tasks, const PartitionResult& result, std::vector<std::vector<Tasks>>& cores) {
+    cores.assign(result.core_utilization.size(), std::vector<Tasks>());
+    for (std::size_t i = 0; i < tasks.size() && i < result.core_of_task.size(); i++) {
+        if (result.core_of_task[i] >= 0) {
+            cores[result.core_of_task[i]].push_back(tasks[i]);
+        }
+    }
+}
+
+const char* partition_fit_name(PartitionFit fit) {
+    switch (fit) {
+        case PARTITION_FIRST_FIT:
+            return "first_fit";
+        case PARTITION_BEST_FIT:
+            return "best_fit";
+        case PARTITION_WORST_FIT:
+            return "worst_fit";
+    }
+    return "unknown";
+}
+
+const char* partition_order_name(PartitionOrder order) {
+    switch (order) {
+        case PARTITION_BY_UTILIZATION:
+            return "utilization";
+        case PARTITION_BY_DENSITY:
+            return "density";
+        case PARTITION_BY_CLEANUP:
+            return "cleanup";
+    }
+    return "unknown";
+}
@@ -0,0 +1,85 @@
+#ifndef MULTI_PHASE_PARTITION_H
+#define MULTI_PHASE_PARTITION_H
+
+#include <vector>
+#include "multi-phase.h"
+
+// Partitioned scheduling on m identical cores: every task is bound to one core and each core runs
+// the uniprocessor multi-phase test on its own tasks. Tasks are placed one at a time in decreasing
+// order of a sort key; a core accepts a task if its IncrementalAnalyzer admits it, so the clean up
+// costs (and through them the trust probability) decide which tasks can share a core, not just the
+// utilization. Several heuristics are tried in parallel and the first feasible one in list order wins.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Number of worker threads that try heuristics (0 = one per hardware thread)
+#define PARTITION_THREADS 0
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Core a task is tried on first
+typedef enum {
+    PARTITION_FIRST_FIT,            // Lowest core index that admits it
+    PARTITION_BEST_FIT,             // Most utilized core that admits it
+    PARTITION_WORST_FIT             // Least utilized core that admits it
+} PartitionFit;
+
+// Key the tasks are sorted by, largest first
+typedef enum {
+    PARTITION_BY_UTILIZATION,       // Ci / Ti
+    PARTITION_BY_DENSITY,           // Ci / min(Di, Ti)
+    PARTITION_BY_CLEANUP            // Largest phase clean up cost; these need the most slack before their deadline
+} PartitionOrder;
+
+typedef struct PartitionHeuristic {
+    PartitionFit fit = PARTITION_FIRST_FIT;
+    PartitionOrder order = PARTITION_BY_UTILIZATION;
+} PartitionHeuristic;
+
+typedef struct PartitionOptions {
+    std::vector<PartitionHeuristic> heuristics;     // In order of preference; empty = partition_heuristics()
+    TestingBound bound = DEFAULT_TESTING_BOUND;     // Bound of the per-core admission test
+    int threads = PARTITION_THREADS;
+} PartitionOptions;
+
+typedef struct PartitionResult {
+    bool feasible = false;
+    PartitionHeuristic heuristic;                   // Heuristic the partition comes from (the first one tried if infeasible)
+    std::vector<int> core_of_task;                  // Core of tasks[i]; -1 for the tasks an infeasible heuristic did not place
+    std::vector<double> core_utilization;           // sum(Ci / Ti) of every core
+    int unplaced_task = -1;                         // Infeasible: first task no core admitted
+    int heuristics_tried = 0;                       // Heuristics that ran to completion or to their first unplaced task
+} PartitionResult;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Every fit with every order, the decreasing-utilization ones first: FFD, BFD, WFD, then by density, then by clean up cost
+std::vector<PartitionHeuristic> partition_heuristics();
+
+// Sort key of a task under an order; tasks are placed largest key first
+double partition_key(const Tasks& task, PartitionOrder order);
+
+// Places 'tasks' onto num_cores cores with one heuristic; false if some task fits on no core
+bool partition_with_heuristic(const std::vector<Tasks>& tasks, int num_cores, PartitionHeuristic heuristic,
+                              TestingBound bound = DEFAULT_TESTING_BOUND, PartitionResult* result = nullptr);
+
+// Tries options.heuristics in parallel and keeps the first feasible one in list order, so the
+// partition does not depend on the number of threads; heuristics after a feasible one are abandoned.
+// false if none is feasible.
+bool partition_tasks(const std::vector<Tasks>& tasks, int num_cores, const PartitionOptions& options = PartitionOptions(),
+                     PartitionResult* result = nullptr);
+
+// Task set of every core of a partition, in task order
+void partition_cores(const std::vector<Tasks>& tasks, const PartitionResult& result, std::vector<std::vector<Tasks>>& cores);
+
+// Names as used in reports, e.g. "best_fit" and "density"
+const char* partition_fit_name(PartitionFit fit);
+const char* partition_order_name(PartitionOrder order);
+
+#endif
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include "multi_phase_report.h"
+
+// One line for the verdict, one per task with its parameters and, if the exact analysis ran, beta and chunk counts
+
+static std::string format_trace(long long index, const Tasks* tasks, std::size_t num_tasks, const AnalysisScratch& scratch,
+                                double utilization) {
+    const AnalysisResult& result = scratch.result;
+    std::ostringstream out;
+    out << "taskset " << index << ": " << analysis_verdict_name(result.verdict) << " U=" << utilization;
+    if (result.verdict != ANALYSIS_SCHEDULABLE) {
+        out << " td=" << result.failing_td << " delta=" << result.delta;
+    }
+    if (result.failing_task >= 0) {
+        out << " task=" << result.failing_task;
+    }
+    if (result.tier != TIER_EXACT) {
+        out << " tier=" << analysis_tier_name(result.tier);
+    }
+    out << "\n";
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        const Tasks& task = tasks[i];
+        out << "  task " << i << ": T=" << task.period << " D=" << task.deadline << " C=" << task.wcet
+            << " cleanup=" << task.cleanup << " phases=" << task.phases;
+        if (result.tier == TIER_EXACT) {
+            out << " beta=" << scratch.beta_per_task[i] << " chunks=";
+            for (int j = 0; j < task.phases; j++) {
+                out << (j == 0 ? "" : ";") << scratch.intervals_per_task_phase[i * MAX_PHASES + j];
+            }
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+void report_taskset(ResultReport& report, long long index, const Tasks* tasks, std::size_t num_tasks, const AnalysisScratch& scratch) {
+
+    double utilization = compute_demand_utilization(scratch.taskset);
+    std::size_t b = std::size_t(std::max(utilization, 0.0) / report.options.bucket_width);
+    if (b >= report.buckets.size()) {
+        report.buckets.resize(b + 1);
+    }
+    report.buckets[b].tasksets++;
+    report.buckets[b].verdicts[scratch.result.verdict]++;
+
+    if (report.options.trace_every > 0 && index % report.options.trace_every == 0) {
+        report.trace.push_back(TraceEntry{index, format_trace(index, tasks, num_tasks, scratch, utilization)});
+    }
+}
+
+void merge_report(ResultReport& into, const ResultReport& from) {
+
+    if (into.buckets.size() < from.buckets.size()) {
+        into.buckets.resize(from.buckets.size());
+    }
+    for (std::size_t b = 0; b < from.buckets.size(); b++) {
+        into.buckets[b].tasksets += from.buckets[b].tasksets;
+        for (int v = 0; v < ANALYSIS_NUM_VERDICTS; v++) {
+            into.buckets[b].verdicts[v] += from.buckets[b].verdicts[v];
+        }
+    }
+
+    into.trace.insert(into.trace.end(), from.trace.begin(), from.trace.end());
+    std::sort(into.trace.begin(), into.trace.end(), [](const TraceEntry& a, const TraceEntry& b) {
+        return a.index < b.index;
+    });
+}
+
+double bucket_utilization(const ResultReport& report, std::size_t b) {
+    return b * report.options.bucket_width;
+}
+
+double acceptance_ratio(const UtilizationBucket& bucket) {
+    return bucket.tasksets == 0 ? 0.0 : double(bucket.verdicts[ANALYSIS_SCHEDULABLE]) / bucket.tasksets;
+}
@@ -0,0 +1,78 @@
+#ifndef MULTI_PHASE_REPORT_H
+#define MULTI_PHASE_REPORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "multi-phase.h"
+
+// Aggregation of analysis results for reporting. The analysis itself prints nothing; a sweep records
+// every task set into a per-worker ResultReport, the reports are merged once the sweep is done and
+// written in one go by the caller.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Width of the utilization buckets the acceptance ratio is reported for
+#define REPORT_BUCKET_WIDTH 0.05
+
+// Every how many task sets a verbose trace entry is recorded (0 = no trace)
+#define REPORT_TRACE_EVERY 0
+
+// Number of AnalysisVerdict and AnalysisTier values
+#define ANALYSIS_NUM_VERDICTS (ANALYSIS_BOUND_BEYOND_HORIZON + 1)
+#define ANALYSIS_NUM_TIERS (TIER_EXACT + 1)
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef enum {
+    REPORT_NONE,                    // Only the scheduled / non-scheduled counters
+    REPORT_CSV,
+    REPORT_JSON
+} ReportFormat;
+
+typedef struct ReportOptions {
+    ReportFormat format = REPORT_NONE;
+    double bucket_width = REPORT_BUCKET_WIDTH;
+    long long trace_every = REPORT_TRACE_EVERY;
+} ReportOptions;
+
+// Task sets whose demand utilization sum(Ci / Ti) falls into one bucket
+typedef struct UtilizationBucket {
+    long long tasksets = 0;
+    long long verdicts[ANALYSIS_NUM_VERDICTS] = {};     // Task sets per AnalysisVerdict; [ANALYSIS_SCHEDULABLE] are the accepted ones
+} UtilizationBucket;
+
+// Verbose description of one sampled task set
+typedef struct TraceEntry {
+    long long index;                // Task set index within the sweep
+    std::string text;
+} TraceEntry;
+
+typedef struct ResultReport {
+    ReportOptions options;
+    std::vector<UtilizationBucket> buckets;     // Bucket b covers [b * bucket_width, (b + 1) * bucket_width)
+    std::vector<TraceEntry> trace;              // Sorted by index after merge_report()
+} ResultReport;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Records task set 'index', analysed with 'scratch' (as left by analyze_taskset()). Allocates only
+// when a new bucket is needed or a trace entry is taken.
+void report_taskset(ResultReport& report, long long index, const Tasks* tasks, std::size_t num_tasks, const AnalysisScratch& scratch);
+
+// Adds the buckets and trace entries of 'from' to 'into'
+void merge_report(ResultReport& into, const ResultReport& from);
+
+// Lower end of bucket b
+double bucket_utilization(const ResultReport& report, std::size_t b);
+
+// Share of the task sets of a bucket that were found schedulable (0 for an empty bucket)
+double acceptance_ratio(const UtilizationBucket& bucket);
+
+#endif
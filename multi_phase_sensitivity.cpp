@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "multi_phase_sensitivity.h"
+#include "work_stealing.h"
+#include "multi_phase_sweep.h"
+
+static const double unbounded = std::numeric_limits<double>::infinity();
+
+// The WCET of every task (task < 0) or of one task multiplied by 'scaling'; the same checks as
+// analyze_taskset() in the same order of strength, on the cached points and job counts
+
+bool SensitivityAnalyzer::probe_wcet(double scaling, int task) {
+
+    const std::size_t n = num_tasks_;
+    for (std::size_t k = 0; k < points_.size(); k++) {
+        double demand = task < 0 ? scaling * demand_[k] : demand_[k] + (scaling - 1.0) * jobs_[k * n + task] * taskset_.wcet[task];
+        delta_[k] = points_[k] - demand;
+        if (delta_[k] < 0.0) {
+            return false;
+        }
+        if (k > 0) {
+            delta_[k] = std::min(delta_[k], delta_[k - 1]);
+        }
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+        if (points_before_[i] == 0) {
+            continue; // No point before Di, so beta is never bounded by the slack
+        }
+        double task_scaling = task < 0 || std::size_t(task) == i ? scaling : 1.0;
+        double beta = 0.0;
+        for (int j = 0; j < tasks_[i].phases; j++) {
+            beta = std::max(beta, task_scaling * task_phase_wcet(tasks_[i], j) + task_phase_cleanup(tasks_[i], j));
+        }
+        double min_delta = delta_[points_before_[i] - 1];
+        if (beta - 1.0 > min_delta) {
+            beta = min_delta + 1.0;
+        }
+        for (int j = 0; j < tasks_[i].phases; j++) {
+            if (!(beta > task_phase_cleanup(tasks_[i], j))) {
+                return false;
+            }
+        }
+    }
+
+    if (bound_ == BOUND_MAX_DEADLINE) {
+        return true;
+    }
+    scaled_ = taskset_;
+    for (std::size_t i = 0; i < n; i++) {
+        if (task < 0 || std::size_t(task) == i) {
+            scaled_.wcet[i] *= scaling;
+        }
+    }
+    return demand_test_beyond_window(scaled_, window_, bound_, scratch_);
+}
+
+// Feasibility only shrinks as a WCET grows (more demand, less slack, and beta_init stays above
+// every clean up cost), so the largest feasible factor is found by doubling, then bisection
+
+double SensitivityAnalyzer::search_wcet(int task, double tolerance, int* probes) {
+
+    double low = 0.0;
+    double high = 1.0;
+    (*probes)++;
+    if (probe_wcet(1.0, task)) {
+        low = 1.0;
+        high = 2.0;
+        while (true) {
+            (*probes)++;
+            if (!probe_wcet(high, task)) {
+                break;
+            }
+            low = high;
+            high *= 2.0;
+            if (high > SENSITIVITY_MAX_SCALING) {
+                return unbounded;
+            }
+        }
+    }
+    while (high - low > tolerance * std::max(high, 1.0)) {
+        double mid = 0.5 * (low + high);
+        (*probes)++;
+        if (probe_wcet(mid, task)) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void SensitivityAnalyzer::analyze(const Tasks* tasks, std::size_t num_tasks, const SensitivityOptions& options,
+                                  SensitivityResult& result) {
+
+    const std::size_t n = num_tasks;
+    tasks_ = tasks;
+    num_tasks_ = n;
+    result.probes = 0;
+    result.per_task.assign(options.per_task ? n : 0, SensitivityFactors());
+    load_taskset(tasks, n, taskset_);
+
+    // Deadline points up to max(D_i), their demand and the job count of every task at them
+    double max_deadline = 0.0;
+    for (std::size_t i = 0; i < n; i++) {
+        max_deadline = std::max(max_deadline, tasks[i].deadline);
+    }
+    window_ = std::floor(max_deadline);
+    enumerate_deadline_points(taskset_, 0.0, window_, points_, heap_);
+    demand_.resize(points_.size());
+    taskset_dbf_points(taskset_, points_.data(), demand_.data(), points_.size());
+    jobs_.assign(points_.size() * n, 0.0);
+    for (std::size_t k = 0; k < points_.size(); k++) {
+        for (std::size_t i = 0; i < n; i++) {
+            if (taskset_.deadline[i] <= points_[k]) {
+                jobs_[k * n + i] = std::floor((points_[k] - taskset_.deadline[i]) / taskset_.period[i]) + 1.0;
+            }
+        }
+    }
+    points_before_.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        points_before_[i] = static_cast<int>(std::lower_bound(points_.begin(), points_.end(), tasks[i].deadline) - points_.begin());
+    }
+    delta_.resize(points_.size());
+
+    // The demand check does not involve clean up; if it fails, no clean up factor helps
+    bool demand_ok = true;
+    for (std::size_t k = 0; k < points_.size() && demand_ok; k++) {
+        delta_[k] = points_[k] - demand_[k];
+        demand_ok = delta_[k] >= 0.0;
+        if (k > 0) {
+            delta_[k] = std::min(delta_[k], delta_[k - 1]);
+        }
+    }
+    demand_ok = demand_ok && demand_test_beyond_window(taskset_, window_, bound_, scratch_);
+
+    // Clean up factors in closed form: every phase's clean up c_j must stay below m_i + 1, because
+    // beta_init_i = max_j(w_j + c_j) always exceeds it (assuming positive phase WCETs)
+    result.taskset = SensitivityFactors();
+    result.taskset.cleanup_scaling = demand_ok ? unbounded : 0.0;
+    result.taskset.cleanup_fraction = demand_ok ? unbounded : 0.0;
+    int failing_cleanups = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        SensitivityFactors factors;
+        if (demand_ok) {
+            factors.cleanup_scaling = unbounded;
+            factors.cleanup_fraction = unbounded;
+            if (points_before_[i] > 0) {
+                double room = delta_[points_before_[i] - 1] + 1.0;
+                double max_cleanup = 0.0;
+                double max_wcet = 0.0;
+                for (int j = 0; j < tasks[i].phases; j++) {
+                    max_cleanup = std::max(max_cleanup, task_phase_cleanup(tasks[i], j));
+                    max_wcet = std::max(max_wcet, task_phase_wcet(tasks[i], j));
+                }
+                if (max_cleanup > 0.0) {
+                    factors.cleanup_scaling = std::max(room / max_cleanup, 0.0);
+                }
+                if (max_wcet > 0.0) {
+                    factors.cleanup_fraction = std::max(room / max_wcet, 0.0);
+                }
+            }
+        }
+        result.taskset.cleanup_scaling = std::min(result.taskset.cleanup_scaling, factors.cleanup_scaling);
+        result.taskset.cleanup_fraction = std::min(result.taskset.cleanup_fraction, factors.cleanup_fraction);
+        if (options.per_task) {
+            result.per_task[i] = factors;
+        }
+        failing_cleanups += factors.cleanup_scaling <= 1.0;
+    }
+
+    // Changing one task's clean up cannot fix another task's: with two failing tasks, or one that is
+    // not task i, no clean up of task i passes
+    for (std::size_t i = 0; i < result.per_task.size(); i++) {
+        int others_failing = failing_cleanups - (result.per_task[i].cleanup_scaling <= 1.0);
+        if (others_failing > 0) {
+            result.per_task[i].cleanup_scaling = 0.0;
+            result.per_task[i].cleanup_fraction = 0.0;
+        }
+    }
+
+    result.schedulable = demand_ok && probe_wcet(1.0, -1);
+    result.probes++;
+    result.taskset.wcet_scaling = search_wcet(-1, options.tolerance, &result.probes);
+    for (std::size_t i = 0; i < result.per_task.size(); i++) {
+        result.per_task[i].wcet_scaling = search_wcet(static_cast<int>(i), options.tolerance, &result.probes);
+    }
+}
+
+void run_sensitivity_sweep(const GeneratorParams& params, long long num_tasksets, uint64_t master_seed, int num_threads,
+                           TestingBound bound, const SensitivityOptions& options, std::vector<SensitivityResult>& results) {
+
+    int num_workers = resolve_num_threads(num_threads);
+    std::vector<GeneratorContext> contexts(num_workers, GeneratorContext(master_seed, 0, SWEEP_RNG_ENGINE));
+    std::vector<std::vector<Tasks>> tasks(num_workers);
+    std::vector<UtilizationSampler> samplers(num_workers);
+    std::vector<SensitivityAnalyzer> analyzers(num_workers, SensitivityAnalyzer(bound));
+    results.resize(num_tasksets);
+
+    parallel_for_each_index(num_tasksets, num_threads, [&](long long index, int worker) {
+        GeneratorContext& ctx = contexts[worker];
+        ctx.seed(master_seed, index);
+        generate_tasks(ctx, params, samplers[worker], tasks[worker]);
+        analyzers[worker].analyze(tasks[worker], options, results[index]);
+    });
+}
@@ -0,0 +1,92 @@
+#ifndef MULTI_PHASE_SENSITIVITY_H
+#define MULTI_PHASE_SENSITIVITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "multi-phase.h"
+
+// Critical scaling factors of a task set: how far the clean up costs or the WCETs can grow before
+// the multi-phase test fails. Clean up is not part of the dbf, so scaling it leaves every deadline
+// point and its slack delta(td) unchanged; it only has to stay below beta_i = min(beta_init_i,
+// m_i + 1), m_i being the least slack before Di. The clean up factors are therefore solved in closed
+// form from one pass over the deadline points. The dbf is linear in the WCETs, so a WCET factor is
+// found by bisection on probes that reuse the deadline points and the per-task job counts at them;
+// only the demand check beyond max(D_i), whose bound depends on the utilization, is re-run per probe.
+// Every factor is a supremum: the test passes for all smaller factors and fails at the factor itself
+// (up to the bisection tolerance for the WCET factors).
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Relative width at which a WCET factor bisection stops
+#define SENSITIVITY_TOLERANCE 1e-6
+
+// WCET factors above this are reported as unbounded
+#define SENSITIVITY_MAX_SCALING 1e6
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef struct SensitivityOptions {
+    double tolerance = SENSITIVITY_TOLERANCE;
+    bool per_task = true;                           // Also the factors of every task on its own (one bisection per task)
+} SensitivityOptions;
+
+// Factors for one task (only its own parameters scaled) or for the whole task set (all scaled alike).
+// Infinity means no amount breaks the test, 0 that it fails at any amount (the demand check fails).
+typedef struct SensitivityFactors {
+    double cleanup_scaling = 0.0;                   // Clean up costs multiplied by this, WCETs unchanged
+    double cleanup_fraction = 0.0;                  // Clean up cost of every phase set to this fraction of its WCET
+    double wcet_scaling = 0.0;                      // WCETs multiplied by this, clean up costs unchanged
+} SensitivityFactors;
+
+typedef struct SensitivityResult {
+    bool schedulable = false;                       // Verdict at the given parameters (all factors 1)
+    SensitivityFactors taskset;
+    std::vector<SensitivityFactors> per_task;       // Empty unless options.per_task
+    int probes = 0;                                 // WCET probes evaluated
+} SensitivityResult;
+
+// Reusable state of the sensitivity analysis; keep one per worker so that steady-state analysis does
+// not allocate
+class SensitivityAnalyzer {
+public:
+    explicit SensitivityAnalyzer(TestingBound bound = DEFAULT_TESTING_BOUND) : bound_(bound) {}
+
+    void analyze(const Tasks* tasks, std::size_t num_tasks, const SensitivityOptions& options, SensitivityResult& result);
+    void analyze(const std::vector<Tasks>& tasks, const SensitivityOptions& options, SensitivityResult& result) {
+        analyze(tasks.data(), tasks.size(), options, result);
+    }
+
+private:
+    bool probe_wcet(double scaling, int task);
+    double search_wcet(int task, double tolerance, int* probes);
+
+    TestingBound bound_;
+    const Tasks* tasks_ = nullptr;
+    std::size_t num_tasks_ = 0;
+    double window_ = 0.0;                           // grid_floor(max D_i)
+    TaskSet taskset_;
+    TaskSet scaled_;                                // Probe copy of taskset_ with scaled WCETs
+    std::vector<double> points_;                    // Deadline points in (0, window_]
+    std::vector<double> demand_;                    // dbf at every point
+    std::vector<double> jobs_;                      // Jobs of task i counted at point k, at [k * num_tasks + i]
+    std::vector<int> points_before_;                // Number of points td < Di of task i
+    std::vector<double> delta_;                     // Probe scratch: slack at every point, then its prefix minimum
+    std::vector<DeadlineEvent> heap_;
+    AnalysisScratch scratch_;                       // Demand check beyond the window
+};
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Generates task sets [0, num_tasksets) of one experiment point (as run_taskset_sweep() does) and
+// analyses them in parallel; results[k] belongs to task set k whatever the number of threads
+void run_sensitivity_sweep(const GeneratorParams& params, long long num_tasksets, uint64_t master_seed, int num_threads,
+                           TestingBound bound, const SensitivityOptions& options, std::vector<SensitivityResult>& results);
+
+#endif
@@ -0,0 +1,195 @@
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include "multi_phase_sim.h"
+#include "work_stealing.h"
+#include "multi_phase_sweep.h"
+
+static int sim_phase_chunks(const int* chunks, int task, int j) {
+    return chunks == nullptr ? 1 : std::max(chunks[task * MAX_PHASES + j], 1);
+}
+
+// Heap orders: earliest release first, and earliest deadline first (FIFO among equal deadlines)
+
+static bool later_release(const SimRelease& a, const SimRelease& b) {
+    return a.time > b.time;
+}
+
+typedef struct LaterDeadline {
+    const std::vector<SimJob>* jobs;
+    bool operator()(int a, int b) const {
+        const SimJob& x = (*jobs)[a];
+        const SimJob& y = (*jobs)[b];
+        return x.deadline > y.deadline || (x.deadline == y.deadline && x.seq > y.seq);
+    }
+} LaterDeadline;
+
+// The processor either runs a chunk of the current phase or the clean up that ends a phase or
+// precedes a preemption. Chunks and clean up are non-preemptive; releases that happen while a segment
+// runs are only looked at when it ends.
+
+void simulate_taskset(const Tasks* tasks, std::size_t num_tasks, const int* chunks, double horizon,
+                      SimScratch& scratch, SimResult& result) {
+
+    std::vector<SimJob>& jobs = scratch.jobs;
+    std::vector<int>& free_jobs = scratch.free_jobs;
+    std::vector<int>& ready = scratch.ready;
+    std::vector<SimRelease>& releases = scratch.releases;
+    LaterDeadline later_deadline = {&jobs};
+
+    jobs.clear();
+    free_jobs.clear();
+    ready.clear();
+    releases.clear();
+
+    result = SimResult();
+    result.per_task.assign(num_tasks, SimTaskStats());
+
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        assert(tasks[i].phases >= 1 && tasks[i].phases <= MAX_PHASES && tasks[i].period > 0);
+        releases.push_back(SimRelease{0.0, static_cast<int>(i)});
+    }
+    std::make_heap(releases.begin(), releases.end(), later_release);
+
+    double now = 0.0;
+    long long seq = 0;
+    int running = -1;               // Job slot on the processor, -1 if idle
+    bool in_cleanup = false;        // The running segment is clean up rather than a chunk
+    bool yield_after = false;       // The running clean up precedes a preemption
+    double segment_end = 0.0;
+    double nonpreemptive_start = 0.0;
+
+    while (running >= 0 || !ready.empty() || !releases.empty()) {
+
+        // Next event: a release (taken first on ties, so it is visible at the segment boundary) or the end of the running segment
+        bool release_next = !releases.empty() && (running < 0 || releases.front().time <= segment_end);
+        if (release_next) {
+            std::pop_heap(releases.begin(), releases.end(), later_release);
+            SimRelease release = releases.back();
+            releases.pop_back();
+            now = std::max(now, release.time);
+
+            const Tasks& task = tasks[release.task];
+            int slot;
+            if (free_jobs.empty()) {
+                slot = static_cast<int>(jobs.size());
+                jobs.push_back(SimJob());
+            } else {
+                slot = free_jobs.back();
+                free_jobs.pop_back();
+            }
+            jobs[slot] = SimJob{release.task, 0, 0, seq++, release.time, release.time + task.deadline};
+            ready.push_back(slot);
+            std::push_heap(ready.begin(), ready.end(), later_deadline);
+
+            double next_release = release.time + task.period;
+            if (next_release < horizon) {
+                releases.push_back(SimRelease{next_release, release.task});
+                std::push_heap(releases.begin(), releases.end(), later_release);
+            }
+            result.events++;
+        } else if (running >= 0) {
+            now = segment_end;
+            result.events++;
+            SimJob& job = jobs[running];
+            const Tasks& task = tasks[job.task];
+            SimTaskStats& stats = result.per_task[job.task];
+            bool switch_out = false;
+
+            if (!in_cleanup) {
+                job.chunk++;
+                bool phase_done = job.chunk == sim_phase_chunks(chunks, job.task, job.phase);
+                bool earlier_ready = !ready.empty() && jobs[ready.front()].deadline < job.deadline;
+                if (phase_done || earlier_ready) {
+                    // Clean up ends the phase, or has to run before the processor is handed over
+                    double cleanup = task_phase_cleanup(task, job.phase);
+                    in_cleanup = true;
+                    yield_after = !phase_done;
+                    segment_end = now + cleanup;
+                    stats.cleanup_time += cleanup;
+                    result.cleanup_time += cleanup;
+                    continue;
+                }
+                stats.max_nonpreemptive = std::max(stats.max_nonpreemptive, now - nonpreemptive_start);
+            } else {
+                in_cleanup = false;
+                stats.max_nonpreemptive = std::max(stats.max_nonpreemptive, now - nonpreemptive_start);
+                if (!yield_after) {
+                    job.phase++;
+                    job.chunk = 0;
+                    if (job.phase == task.phases) {
+                        double response_time = now - job.release;
+                        stats.jobs++;
+                        stats.total_response_time += response_time;
+                        stats.max_response_time = std::max(stats.max_response_time, response_time);
+                        if (now > job.deadline) {
+                            stats.deadline_misses++;
+                        }
+                        free_jobs.push_back(running);
+                        running = -1;
+                    }
+                }
+                switch_out = running >= 0 && (yield_after || (!ready.empty() && jobs[ready.front()].deadline < job.deadline));
+                yield_after = false;
+            }
+
+            if (switch_out) {
+                stats.preemptions++;
+                ready.push_back(running);
+                std::push_heap(ready.begin(), ready.end(), later_deadline);
+                running = -1;
+            } else if (running >= 0) {
+                nonpreemptive_start = now;
+                segment_end = now + task_phase_wcet(task, job.phase) / sim_phase_chunks(chunks, job.task, job.phase);
+                continue;
+            }
+        }
+
+        // Dispatch the earliest-deadline ready job on an idle processor
+        if (running < 0 && !ready.empty() && (releases.empty() || releases.front().time > now)) {
+            std::pop_heap(ready.begin(), ready.end(), later_deadline);
+            running = ready.back();
+            ready.pop_back();
+            const SimJob& job = jobs[running];
+            nonpreemptive_start = now;
+            in_cleanup = false;
+            segment_end = now + task_phase_wcet(tasks[job.task], job.phase) / sim_phase_chunks(chunks, job.task, job.phase);
+        }
+    }
+
+    result.end_time = now;
+    for (const SimTaskStats& stats : result.per_task) {
+        result.jobs += stats.jobs;
+        result.deadline_misses += stats.deadline_misses;
+        result.preemptions += stats.preemptions;
+        result.max_response_time = std::max(result.max_response_time, stats.max_response_time);
+    }
+}
+
+void simulate_analyzed_taskset(const Tasks* tasks, std::size_t num_tasks, const AnalysisScratch& analysis,
+                               SimScratch& scratch, SimResult& result, double horizon) {
+    assert(analysis.intervals_per_task_phase.size() >= num_tasks * MAX_PHASES);
+    simulate_taskset(tasks, num_tasks, analysis.intervals_per_task_phase.data(), horizon, scratch, result);
+}
+
+void run_simulation_sweep(const GeneratorParams& params, long long num_tasksets, uint64_t master_seed, int num_threads,
+                          TestingBound bound, double horizon, std::vector<SimTasksetResult>& results) {
+
+    int num_workers = resolve_num_threads(num_threads);
+    std::vector<GeneratorContext> contexts(num_workers, GeneratorContext(master_seed, 0, SWEEP_RNG_ENGINE));
+    std::vector<std::vector<Tasks>> tasks(num_workers);
+    std::vector<UtilizationSampler> samplers(num_workers);
+    std::vector<AnalysisScratch> analyses(num_workers);
+    std::vector<SimScratch> sims(num_workers);
+    results.resize(num_tasksets);
+
+    parallel_for_each_index(num_tasksets, num_threads, [&](long long index, int worker) {
+        GeneratorContext& ctx = contexts[worker];
+        ctx.seed(master_seed, index);
+        generate_tasks(ctx, params, samplers[worker], tasks[worker]);
+        SimTasksetResult& result = results[index];
+        result.schedulable = analyze_taskset(tasks[worker].data(), tasks[worker].size(), bound, analyses[worker]);
+        result.beta_per_task = analyses[worker].beta_per_task;
+        simulate_analyzed_taskset(tasks[worker].data(), tasks[worker].size(), analyses[worker], sims[worker], result.sim, horizon);
+    });
+}
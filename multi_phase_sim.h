@@ -0,0 +1,98 @@
+#ifndef MULTI_PHASE_SIM_H
+#define MULTI_PHASE_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "multi-phase.h"
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Default length of a simulation run (jobs are released in [0, horizon) and then run to completion)
+#define SIM_DEFAULT_HORIZON 100000.0
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Per-task outcome of a simulation run
+typedef struct SimTaskStats {
+    long long jobs = 0;                     // Jobs released and completed
+    long long deadline_misses = 0;          // Jobs that completed after their absolute deadline
+    long long preemptions = 0;              // Times a job of the task was switched out before completing
+    double max_response_time = 0.0;
+    double total_response_time = 0.0;
+    double cleanup_time = 0.0;              // Clean up time charged to the task
+    double max_nonpreemptive = 0.0;         // Longest chunk plus clean up run without a preemption point (compare with beta)
+} SimTaskStats;
+
+// Outcome of a simulation run; per_task is parallel to the simulated task array
+typedef struct SimResult {
+    long long jobs = 0;
+    long long deadline_misses = 0;
+    long long preemptions = 0;
+    long long events = 0;                   // Releases plus segment completions processed
+    double max_response_time = 0.0;
+    double cleanup_time = 0.0;
+    double end_time = 0.0;                  // Time at which the last job completed
+    std::vector<SimTaskStats> per_task;
+} SimResult;
+
+// Outcome of one task set of a simulation sweep
+typedef struct SimTasksetResult {
+    bool schedulable = false;               // Verdict of the analysis the chunk counts come from
+    std::vector<double> beta_per_task;      // Beta of every task, to compare with max_nonpreemptive
+    SimResult sim;
+} SimTasksetResult;
+
+// One released job
+typedef struct SimJob {
+    int task;
+    int phase;                              // Phase being executed
+    int chunk;                              // Chunks of that phase already completed
+    long long seq;                          // Release order, breaks deadline ties (FIFO)
+    double release;
+    double deadline;                        // Absolute deadline
+} SimJob;
+
+// Next release of a task
+typedef struct SimRelease {
+    double time;
+    int task;
+} SimRelease;
+
+// Working memory of the simulator, reused across runs so that steady-state simulation does not allocate
+typedef struct SimScratch {
+    std::vector<SimJob> jobs;               // Job pool; finished slots are recycled through free_jobs
+    std::vector<int> free_jobs;
+    std::vector<int> ready;                 // EDF ready queue: binary heap of job slots
+    std::vector<SimRelease> releases;       // Release events: binary heap on time
+} SimScratch;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Simulates tasks[0 .. num_tasks) on one processor under EDF with limited-preemption multi-phase
+// semantics. Every task is released periodically from time 0. Phase j of a job executes in
+// chunks[i * MAX_PHASES + j] equal non-preemptive chunks (one chunk per phase if chunks is null);
+// a job can only be preempted at a chunk boundary. The clean up cost of a phase is charged, non-
+// preemptively, at the end of the phase and whenever the job is preempted within it.
+// Phase j executes task_phase_wcet(): with uniform phases every phase runs the full wcet, the bound the
+// analysis sizes its chunks and beta with.
+void simulate_taskset(const Tasks* tasks, std::size_t num_tasks, const int* chunks, double horizon,
+                      SimScratch& scratch, SimResult& result);
+
+// Simulates a task set with the chunk counts the analysis left in 'analysis' for it
+void simulate_analyzed_taskset(const Tasks* tasks, std::size_t num_tasks, const AnalysisScratch& analysis,
+                               SimScratch& scratch, SimResult& result, double horizon = SIM_DEFAULT_HORIZON);
+
+// Generates task sets [0, num_tasksets) of one experiment point (as run_taskset_sweep() does), analyses
+// them and simulates each with the chunk counts of its analysis; results[k] belongs to task set k
+// whatever the number of threads
+void run_simulation_sweep(const GeneratorParams& params, long long num_tasksets, uint64_t master_seed, int num_threads,
+                          TestingBound bound, double horizon, std::vector<SimTasksetResult>& results);
+
+#endif
@@ -0,0 +1,72 @@
+#include <vector>
+#include "multi_phase_sweep.h"
+#include "multi-phase.h"
+#include "work_stealing.h"
+
+void add_sweep_counters(SweepCounters& into, const SweepCounters& from) {
+    into.total_scheduled += from.total_scheduled;
+    into.total_non_scheduled += from.total_non_scheduled;
+    for (int t = 0; t < ANALYSIS_NUM_TIERS; t++) {
+        into.decided_by[t] += from.decided_by[t];
+    }
+}
+
+void print_sweep_tiers(std::ostream& out, const SweepCounters& counters) {
+    out << "Decided by:";
+    for (int t = 0; t < ANALYSIS_NUM_TIERS; t++) {
+        out << " " << analysis_tier_name(AnalysisTier(t)) << "=" << counters.decided_by[t];
+    }
+    out << "\n";
+}
+
+SweepCounters run_taskset_sweep(long long num_tasksets, uint64_t master_seed, int num_threads) {
+    return run_taskset_sweep(GeneratorParams(), num_tasksets, master_seed, num_threads, DEFAULT_TESTING_BOUND);
+}
+
+SweepCounters run_taskset_sweep(const GeneratorParams& params, long long num_tasksets, uint64_t master_seed,
+                                int num_threads, TestingBound bound, ResultReport* report) {
+    return run_taskset_sweep_range(params, 0, num_tasksets, master_seed, num_threads, bound, report);
+}
+
+SweepCounters run_taskset_sweep_range(const GeneratorParams& params, long long first_index, long long num_tasksets,
+                                      uint64_t master_seed, int num_threads, TestingBound bound, ResultReport* report) {
+
+    int num_workers = resolve_num_threads(num_threads);
+    std::vector<SweepCounters> per_worker(num_workers);
+    std::vector<GeneratorContext> contexts(num_workers, GeneratorContext(master_seed, 0, SWEEP_RNG_ENGINE));
+    std::vector<std::vector<Tasks>> tasks(num_workers);
+    std::vector<UtilizationSampler> samplers(num_workers);
+    std::vector<AnalysisScratch> scratch(num_workers);
+    std::vector<ResultReport> per_worker_report;
+    if (report != nullptr) {
+        ResultReport empty;
+        empty.options = report->options;
+        per_worker_report.assign(num_workers, empty);
+    }
+
+    // Every worker reuses its own task buffer, utilization sampler and analysis scratch, so the loop does not allocate
+    parallel_for_each_index(num_tasksets, num_threads, [&](long long offset, int worker) {
+        long long index = first_index + offset;
+        GeneratorContext& ctx = contexts[worker];
+        ctx.seed(master_seed, index);
+        generate_tasks(ctx, params, samplers[worker], tasks[worker]);
+        if (analyze_taskset_tiered(tasks[worker].data(), tasks[worker].size(), bound, scratch[worker])) {
+            per_worker[worker].total_scheduled++;
+        } else {
+            per_worker[worker].total_non_scheduled++;
+        }
+        per_worker[worker].decided_by[scratch[worker].result.tier]++;
+        if (report != nullptr) {
+            report_taskset(per_worker_report[worker], index, tasks[worker].data(), tasks[worker].size(), scratch[worker]);
+        }
+    });
+
+    SweepCounters total;
+    for (const SweepCounters& counters : per_worker) {
+        add_sweep_counters(total, counters);
+    }
+    for (const ResultReport& worker_report : per_worker_report) {
+        merge_report(*report, worker_report);
+    }
+    return total;
+}
@@ -0,0 +1,59 @@
+#ifndef MULTI_PHASE_SWEEP_H
+#define MULTI_PHASE_SWEEP_H
+
+#include <cstdint>
+#include <ostream>
+#include "multi_phase_generator.h"
+#include "multi_phase_bound.h"
+#include "multi_phase_report.h"
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Master seed of a sweep; task set k is generated from stream k of this seed
+#define SWEEP_MASTER_SEED 0x5eedULL
+
+// Random engine of the per-worker generator contexts
+#define SWEEP_RNG_ENGINE DEFAULT_RNG_ENGINE
+
+// Number of worker threads (0 = one per hardware thread)
+#define SWEEP_THREADS 0
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Outcome counters of a sweep, kept per worker and merged once at the end
+typedef struct alignas(64) SweepCounters {
+    long long total_scheduled = 0;
+    long long total_non_scheduled = 0;
+    long long decided_by[ANALYSIS_NUM_TIERS] = {};     // Task sets per AnalysisTier that decided them
+} SweepCounters;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Adds the counters of 'from' to 'into'
+void add_sweep_counters(SweepCounters& into, const SweepCounters& from);
+
+// One line "Decided by: utilization=... exact=..." with the task sets each analysis tier decided
+void print_sweep_tiers(std::ostream& out, const SweepCounters& counters);
+
+// Generates and tests num_tasksets task sets in parallel with analyze_taskset_tiered(); the counters
+// only depend on the master seed, not on the number of threads or on how the work was distributed
+SweepCounters run_taskset_sweep(long long num_tasksets, uint64_t master_seed, int num_threads);
+
+// Same for the task sets of one experiment point, tested with 'bound'. If 'report' is given, every
+// task set is also recorded into it (with report->options; buckets and trace are added to).
+SweepCounters run_taskset_sweep(const GeneratorParams& params, long long num_tasksets, uint64_t master_seed,
+                                int num_threads, TestingBound bound = DEFAULT_TESTING_BOUND, ResultReport* report = nullptr);
+
+// Same for task sets [first_index, first_index + num_tasksets), so that a point can be sampled in
+// consecutive batches that together draw the same task sets as one sweep of the combined count
+SweepCounters run_taskset_sweep_range(const GeneratorParams& params, long long first_index, long long num_tasksets,
+                                      uint64_t master_seed, int num_threads, TestingBound bound = DEFAULT_TESTING_BOUND,
+                                      ResultReport* report = nullptr);
+
+#endif
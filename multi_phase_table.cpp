@@ -0,0 +1,496 @@
+#include <cstdio>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "multi_phase_table.h"
+
+static ScheduleTableHeader make_table_header(std::size_t num_tasks, Ticks ticks_per_unit, Ticks hyperperiod, uint64_t num_entries) {
+    ScheduleTableHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+    header.version = TABLE_VERSION;
+    header.header_size = sizeof(ScheduleTableHeader);
+    header.byte_order_mark = TABLE_BYTE_ORDER_MARK;
+    header.task_size = sizeof(TableTask);
+    header.entry_size = sizeof(TableEntry);
+    header.num_tasks = static_cast<uint32_t>(num_tasks);
+    header.ticks_per_unit = ticks_per_unit;
+    header.hyperperiod = hyperperiod;
+    header.num_entries = num_entries;
+    header.entry_offset = sizeof(ScheduleTableHeader) + num_tasks * sizeof(TableTask);
+    return header;
+}
+
+// Start of chunk c of a phase of 'length' ticks split into n chunks, relative to the phase start.
+// The chunks differ in length by at most one tick and add up to the phase exactly.
+
+static Ticks chunk_offset(Ticks length, Ticks n, Ticks c) {
+    return c * length / n;
+}
+
+ScheduleTableWriter::~ScheduleTableWriter() {
+    close();
+}
+
+bool ScheduleTableWriter::open(const char* path, const std::vector<TableTask>& tasks, Ticks ticks_per_unit, Ticks hyperperiod) {
+    close();
+    file_ = std::fopen(path, "wb");
+    if (file_ == nullptr) {
+        return false;
+    }
+    failed_ = false;
+    has_pending_ = false;
+    entries_ = 0;
+
+    // Placeholder header: an unfinished file has no entries
+    header_ = make_table_header(tasks.size(), ticks_per_unit, hyperperiod, 0);
+    failed_ = std::fwrite(&header_, sizeof(header_), 1, file_) != 1;
+    if (!failed_ && !tasks.empty()) {
+        failed_ = std::fwrite(tasks.data(), sizeof(TableTask), tasks.size(), file_) != tasks.size();
+    }
+    return !failed_;
+}
+
+bool ScheduleTableWriter::flush_pending() {
+    if (has_pending_ && !failed_) {
+        failed_ = std::fwrite(&pending_, sizeof(pending_), 1, file_) != 1;
+        entries_++;
+    }
+    has_pending_ = false;
+    return !failed_;
+}
+
+bool ScheduleTableWriter::append(const TableEntry& entry) {
+
+    assert(file_ != nullptr);
+    if (entry.length == 0) {
+        return !failed_;
+    }
+    assert(!has_pending_ || entry.start >= pending_.start + pending_.length);
+
+    // The next chunk of the same phase right after the pending run extends it
+    if (has_pending_ && entry.kind == TABLE_CHUNK && pending_.kind == TABLE_CHUNK && entry.task == pending_.task &&
+        entry.phase == pending_.phase && entry.first_chunk == pending_.first_chunk + pending_.num_chunks &&
+        entry.start == pending_.start + pending_.length &&
+        uint64_t(pending_.length) + entry.length <= std::numeric_limits<uint32_t>::max()) {
+        pending_.length += entry.length;
+        pending_.num_chunks += entry.num_chunks;
+        return !failed_;
+    }
+    flush_pending();
+    pending_ = entry;
+    has_pending_ = true;
+    return !failed_;
+}
+
+bool ScheduleTableWriter::close() {
+    if (file_ == nullptr) {
+        return !failed_;
+    }
+    flush_pending();
+    header_.num_entries = entries_;
+    if (!failed_) {
+        failed_ = std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&header_, sizeof(header_), 1, file_) != 1;
+    }
+    failed_ = (std::fclose(file_) != 0) || failed_;
+    file_ = nullptr;
+    return !failed_;
+}
+
+ScheduleTableReader::~ScheduleTableReader() {
+    close();
+}
+
+void ScheduleTableReader::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<unsigned char*>(data_), length_);
+    }
+    data_ = nullptr;
+    length_ = 0;
+    header_ = nullptr;
+    tasks_ = nullptr;
+    entries_ = nullptr;
+}
+
+bool ScheduleTableReader::open(const char* path, std::string* error) {
+
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        *error = std::string("cannot open '") + path + "'";
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(ScheduleTableHeader))) {
+        ::close(fd);
+        *error = std::string("'") + path + "' is too short to be a schedule table";
+        return false;
+    }
+    length_ = static_cast<std::size_t>(status.st_size);
+    void* mapping = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        length_ = 0;
+        *error = std::string("cannot map '") + path + "'";
+        return false;
+    }
+    data_ = static_cast<const unsigned char*>(mapping);
+
+    header_ = reinterpret_cast<const ScheduleTableHeader*>(data_);
+    uint64_t tasks_end = sizeof(ScheduleTableHeader) + uint64_t(header_->num_tasks) * sizeof(TableTask);
+    if (std::memcmp(header_->magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) != 0) {
+        *error = std::string("'") + path + "' is not a schedule table";
+    } else if (header_->byte_order_mark != TABLE_BYTE_ORDER_MARK) {
+        *error = std::string("'") + path + "' was written on a machine with a different byte order";
+    } else if (header_->version != TABLE_VERSION || header_->header_size != sizeof(ScheduleTableHeader) ||
+               header_->task_size != sizeof(TableTask) || header_->entry_size != sizeof(TableEntry)) {
+        *error = std::string("'") + path + "' has unsupported table version " + std::to_string(header_->version);
+    } else if (header_->entry_offset != tasks_end || header_->hyperperiod <= 0 || tasks_end > length_ ||
+               header_->num_entries > (length_ - tasks_end) / sizeof(TableEntry)) {
+        *error = std::string("'") + path + "' is unfinished or truncated";
+    } else {
+        error->clear();
+    }
+    if (!error->empty()) {
+        close();
+        return false;
+    }
+    tasks_ = reinterpret_cast<const TableTask*>(data_ + sizeof(ScheduleTableHeader));
+    entries_ = reinterpret_cast<const TableEntry*>(data_ + tasks_end);
+    return true;
+}
+
+TableSlot ScheduleTableReader::lookup(Ticks t) const {
+
+    assert(header_ != nullptr && t >= 0);
+    Ticks offset = t % header_->hyperperiod;
+    const TableEntry* end = entries_ + header_->num_entries;
+    const TableEntry* next = std::upper_bound(entries_, end, offset,
+                                              [](Ticks key, const TableEntry& entry) { return key < entry.start; });
+
+    TableSlot slot;
+    if (next == entries_ || offset >= (next - 1)->start + Ticks((next - 1)->length)) {
+        // Idle gap between the previous entry (or the start) and the next one (or the end)
+        slot.start = next == entries_ ? 0 : (next - 1)->start + Ticks((next - 1)->length);
+        slot.end = next == end ? header_->hyperperiod : next->start;
+        return slot;
+    }
+
+    const TableEntry& entry = *(next - 1);
+    slot.kind = static_cast<TableEntryKind>(entry.kind);
+    slot.task = entry.task;
+    slot.phase = entry.phase;
+    slot.chunk = entry.first_chunk;
+    slot.start = entry.start;
+    slot.end = entry.start + entry.length;
+    if (slot.kind == TABLE_CHUNK) {
+        // Offset into the phase, then the chunk c with offset(c) <= position < offset(c + 1)
+        const TableTask& task = tasks_[entry.task];
+        Ticks length = task.phase_wcet[entry.phase];
+        Ticks n = task.chunks[entry.phase];
+        Ticks run_start = chunk_offset(length, n, entry.first_chunk);
+        Ticks position = run_start + (offset - entry.start);
+        Ticks c = ((position + 1) * n - 1) / length;
+        slot.chunk = static_cast<int>(c);
+        slot.start = entry.start + chunk_offset(length, n, c) - run_start;
+        slot.end = entry.start + chunk_offset(length, n, c + 1) - run_start;
+    }
+    return slot;
+}
+
+bool compute_hyperperiod(const TickTask* tasks, std::size_t num_tasks, Ticks* hyperperiod) {
+    Ticks result = 1;
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        Ticks a = result;
+        Ticks b = tasks[i].period;
+        while (b != 0) {
+            Ticks r = a % b;
+            a = b;
+            b = r;
+        }
+        Ticks factor = tasks[i].period / a;
+        if (factor > TimeTraits<Ticks>::horizon() / result) {
+            return false;
+        }
+        result *= factor;
+    }
+    *hyperperiod = result;
+    return true;
+}
+
+// One released job of the table synthesis
+typedef struct TableJob {
+    int task;
+    int phase;
+    int chunk;                  // Chunks of that phase already completed
+    long long seq;              // Release order, breaks deadline ties (FIFO)
+    Ticks release;
+    Ticks deadline;             // Absolute deadline
+} TableJob;
+
+typedef struct TableRelease {
+    Ticks time;
+    int task;
+} TableRelease;
+
+// Earliest-deadline job on top of the ready heap, earliest release on top of the release heap
+
+typedef struct TableLaterDeadline {
+    const std::vector<TableJob>* jobs;
+    bool operator()(int a, int b) const {
+        const TableJob& x = (*jobs)[a];
+        const TableJob& y = (*jobs)[b];
+        return x.deadline > y.deadline || (x.deadline == y.deadline && x.seq > y.seq);
+    }
+} TableLaterDeadline;
+
+static bool later_table_release(const TableRelease& a, const TableRelease& b) {
+    return a.time > b.time;
+}
+
+static TableEntry make_entry(Ticks start, Ticks length, int task, int phase, TableEntryKind kind, int chunk) {
+    TableEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.start = start;
+    entry.length = static_cast<uint32_t>(length);
+    entry.task = static_cast<uint16_t>(task);
+    entry.phase = static_cast<uint8_t>(phase);
+    entry.kind = static_cast<uint8_t>(kind);
+    entry.first_chunk = static_cast<uint32_t>(chunk);
+    entry.num_chunks = kind == TABLE_CHUNK ? 1 : 0;
+    return entry;
+}
+
+bool write_schedule_table(const char* path, const TickTask* tasks, std::size_t num_tasks, const int* chunks,
+                          Ticks ticks_per_unit, std::string* error, ScheduleTableStats* stats, long long max_jobs) {
+
+    // Task table, checked against the limits of the entry format
+    error->clear();
+    std::vector<TableTask> table_tasks(num_tasks);
+    long long total_jobs = 0;
+    Ticks hyperperiod = 0;
+    if (num_tasks > std::numeric_limits<uint16_t>::max()) {
+        *error = "too many tasks for a schedule table";
+        return false;
+    }
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        const TickTask& task = tasks[i];
+        if (task.period <= 0 || task.deadline > task.period || task.phases < 1 || task.phases > MAX_PHASES) {
+            *error = "task " + std::to_string(i) + " needs a positive period, a deadline within its period and 1 to " +
+                     std::to_string(MAX_PHASES) + " phases";
+            return false;
+        }
+        TableTask& entry = table_tasks[i];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.id = task.id;
+        entry.phases = static_cast<uint16_t>(task.phases);
+        entry.period = task.period;
+        entry.deadline = task.deadline;
+        for (int j = 0; j < task.phases; j++) {
+            entry.phase_wcet[j] = task_phase_wcet(task, j);
+            entry.phase_cleanup[j] = task_phase_cleanup(task, j);
+            entry.chunks[j] = chunks == nullptr ? 1 : static_cast<uint32_t>(std::max(chunks[i * MAX_PHASES + j], 1));
+            if (entry.phase_wcet[j] > Ticks(std::numeric_limits<uint32_t>::max()) ||
+                entry.phase_cleanup[j] > Ticks(std::numeric_limits<uint32_t>::max())) {
+                *error = "phase " + std::to_string(j) + " of task " + std::to_string(i) + " is too long for a table entry";
+                return false;
+            }
+        }
+    }
+    if (!compute_hyperperiod(tasks, num_tasks, &hyperperiod)) {
+        *error = "the hyperperiod overflows the tick range";
+        return false;
+    }
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        total_jobs += hyperperiod / tasks[i].period;
+        if (total_jobs > max_jobs) {
+            *error = "the hyperperiod of " + std::to_string(hyperperiod) + " ticks holds more than " +
+                     std::to_string(max_jobs) + " jobs";
+            return false;
+        }
+    }
+
+    ScheduleTableWriter writer;
+    if (!writer.open(path, table_tasks, ticks_per_unit, hyperperiod)) {
+        *error = std::string("cannot create '") + path + "'";
+        return false;
+    }
+
+    // Limited-preemption EDF with the rules of simulate_taskset(), on ticks and over one hyperperiod.
+    // Every segment is appended to the table when it starts; it cannot be interrupted.
+    ScheduleTableStats local;
+    local.hyperperiod = hyperperiod;
+    std::vector<TableJob> jobs;
+    std::vector<int> free_jobs;
+    std::vector<int> ready;
+    std::vector<TableRelease> releases;
+    TableLaterDeadline later_deadline = {&jobs};
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        releases.push_back(TableRelease{0, static_cast<int>(i)});
+    }
+    std::make_heap(releases.begin(), releases.end(), later_table_release);
+
+    auto chunk_length = [&table_tasks](const TableJob& job) {
+        const TableTask& task = table_tasks[job.task];
+        Ticks length = task.phase_wcet[job.phase];
+        Ticks n = task.chunks[job.phase];
+        return chunk_offset(length, n, job.chunk + 1) - chunk_offset(length, n, job.chunk);
+    };
+
+    Ticks now = 0;
+    long long seq = 0;
+    int running = -1;
+    bool in_cleanup = false;
+    bool yield_after = false;
+    Ticks segment_end = 0;
+    bool ok = true;
+
+    auto start_chunk = [&]() {
+        const TableJob& job = jobs[running];
+        Ticks length = chunk_length(job);
+        segment_end = now + length;
+        local.segments++;
+        local.busy += length;
+        ok = writer.append(make_entry(now, length, job.task, job.phase, TABLE_CHUNK, job.chunk)) && ok;
+    };
+
+    while (ok && (running >= 0 || !ready.empty() || !releases.empty())) {
+
+        bool release_next = !releases.empty() && (running < 0 || releases.front().time <= segment_end);
+        if (release_next) {
+            std::pop_heap(releases.begin(), releases.end(), later_table_release);
+            TableRelease release = releases.back();
+            releases.pop_back();
+            now = std::max(now, release.time);
+
+            int slot;
+            if (free_jobs.empty()) {
+                slot = static_cast<int>(jobs.size());
+                jobs.push_back(TableJob());
+            } else {
+                slot = free_jobs.back();
+                free_jobs.pop_back();
+            }
+            jobs[slot] = TableJob{release.task, 0, 0, seq++, release.time, release.time + tasks[release.task].deadline};
+            ready.push_back(slot);
+            std::push_heap(ready.begin(), ready.end(), later_deadline);
+
+            Ticks next_release = release.time + tasks[release.task].period;
+            if (next_release < hyperperiod) {
+                releases.push_back(TableRelease{next_release, release.task});
+                std::push_heap(releases.begin(), releases.end(), later_table_release);
+            }
+        } else if (running >= 0) {
+            now = segment_end;
+            TableJob& job = jobs[running];
+            const TableTask& task = table_tasks[job.task];
+            bool switch_out = false;
+
+            if (!in_cleanup) {
+                job.chunk++;
+                bool phase_done = job.chunk == int(task.chunks[job.phase]);
+                bool earlier_ready = !ready.empty() && jobs[ready.front()].deadline < job.deadline;
+                if (phase_done || earlier_ready) {
+                    Ticks cleanup = task.phase_cleanup[job.phase];
+                    in_cleanup = true;
+                    yield_after = !phase_done;
+                    segment_end = now + cleanup;
+                    local.segments += cleanup > 0;
+                    local.busy += cleanup;
+                    ok = writer.append(make_entry(now, cleanup, job.task, job.phase,
+                                                  yield_after ? TABLE_CLEANUP_PREEMPT : TABLE_CLEANUP, job.chunk));
+                    continue;
+                }
+            } else {
+                in_cleanup = false;
+                if (!yield_after) {
+                    job.phase++;
+                    job.chunk = 0;
+                    if (job.phase == task.phases) {
+                        if (now > job.deadline) {
+                            *error = "job of task " + std::to_string(job.task) + " released at tick " +
+                                     std::to_string(job.release) + " misses its deadline in the table";
+                            ok = false;
+                            break;
+                        }
+                        local.jobs++;
+                        free_jobs.push_back(running);
+                        running = -1;
+                    }
+                }
+                switch_out = running >= 0 && (yield_after || (!ready.empty() && jobs[ready.front()].deadline < job.deadline));
+                yield_after = false;
+            }
+
+            if (switch_out) {
+                local.preemptions++;
+                ready.push_back(running);
+                std::push_heap(ready.begin(), ready.end(), later_deadline);
+                running = -1;
+            } else if (running >= 0) {
+                start_chunk();
+                continue;
+            }
+        }
+
+        if (running < 0 && !ready.empty() && (releases.empty() || releases.front().time > now)) {
+            std::pop_heap(ready.begin(), ready.end(), later_deadline);
+            running = ready.back();
+            ready.pop_back();
+            in_cleanup = false;
+            start_chunk();
+        }
+    }
+
+    bool closed = writer.close();
+    if (ok && now > hyperperiod) {
+        *error = "the schedule does not complete within the hyperperiod";
+        ok = false;
+    }
+    if (!ok || !closed) {
+        if (error->empty()) {
+            *error = std::string("cannot write '") + path + "'";
+        }
+        std::remove(path); // A partial table must not be deployed
+        return false;
+    }
+    local.entries = writer.count();
+    if (stats != nullptr) {
+        *stats = local;
+    }
+    return true;
+}
+
+bool write_schedule_table(const char* path, const std::vector<Tasks>& tasks, Ticks ticks_per_unit, TestingBound bound,
+                          std::string* error, ScheduleTableStats* stats, long long max_jobs) {
+    std::vector<TickTask> tick_tasks;
+    convert_to_ticks(tasks, ticks_per_unit, tick_tasks);
+    TickAnalysisScratch scratch;
+    if (!analyze_taskset(tick_tasks.data(), tick_tasks.size(), bound, scratch)) {
+        *error = std::string("the task set is not schedulable on the tick grid (") + analysis_verdict_name(scratch.result.verdict) + ")";
+        return false;
+    }
+    return write_schedule_table(path, tick_tasks.data(), tick_tasks.size(), scratch.intervals_per_task_phase.data(),
+                                ticks_per_unit, error, stats, max_jobs);
+}
+
+const char* table_entry_kind_name(TableEntryKind kind) {
+    switch (kind) {
+        case TABLE_IDLE:
+            return "idle";
+        case TABLE_CHUNK:
+            return "chunk";
+        case TABLE_CLEANUP:
+            return "cleanup";
+        case TABLE_CLEANUP_PREEMPT:
+            return "cleanup_preempt";
+    }
+    return "unknown";
+}
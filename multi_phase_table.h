@@ -0,0 +1,191 @@
+#ifndef MULTI_PHASE_TABLE_H
+#define MULTI_PHASE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "multi-phase.h"
+
+// Static dispatch table (.mptab) of one hyperperiod for time-triggered deployment. The table is the
+// schedule the limited-preemption EDF of simulate_taskset() produces on integer clock ticks, with the
+// chunk counts of the analysis: every chunk and clean up segment has a fixed slot. With Di <= Ti every
+// job released in [0, H) completes by H, so the table repeats every hyperperiod H.
+//
+//   ScheduleTableHeader                            64 bytes
+//   TableTask[num_tasks]                           168 bytes each: tick parameters and chunk counts
+//   TableEntry[num_entries]                        24 bytes each, sorted by start
+//
+// Consecutive chunks of one phase that run back to back are stored as one entry (run-length
+// encoding); the chunk boundaries inside an entry follow from the phase length and chunk count in the
+// task table. Idle time is not stored. Entries are written as they are produced, so only the tasks
+// and one pending entry are in memory however long the hyperperiod is. As in the corpus, numbers are
+// stored in the byte order of the writing machine.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+#define TABLE_MAGIC "MPTABLE"
+#define TABLE_VERSION 1
+#define TABLE_BYTE_ORDER_MARK 0x01020304u
+
+// Most jobs a table may contain before synthesis is refused
+#define TABLE_MAX_JOBS (1LL << 32)
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef enum {
+    TABLE_IDLE,                     // Lookups only: nothing is dispatched
+    TABLE_CHUNK,                    // Non-preemptive chunks of a phase
+    TABLE_CLEANUP,                  // Clean up at the end of a phase
+    TABLE_CLEANUP_PREEMPT           // Clean up before the job is preempted within a phase
+} TableEntryKind;
+
+typedef struct ScheduleTableHeader {
+    char magic[8];                  // TABLE_MAGIC, NUL terminated
+    uint16_t version;               // TABLE_VERSION
+    uint16_t header_size;           // sizeof(ScheduleTableHeader)
+    uint32_t byte_order_mark;       // TABLE_BYTE_ORDER_MARK as written by the producer
+    uint32_t task_size;             // sizeof(TableTask)
+    uint32_t entry_size;            // sizeof(TableEntry)
+    uint32_t num_tasks;
+    uint32_t reserved0;
+    int64_t ticks_per_unit;
+    int64_t hyperperiod;            // In ticks
+    uint64_t num_entries;           // 0 if the writer did not finish
+    uint64_t entry_offset;          // File offset of the first entry
+} ScheduleTableHeader;
+
+typedef struct TableTask {
+    int32_t id;
+    uint16_t phases;
+    uint16_t reserved0;
+    int64_t period;
+    int64_t deadline;
+    int64_t phase_wcet[MAX_PHASES];         // Ticks of phase j, task_phase_wcet() as in simulate_taskset()
+    int64_t phase_cleanup[MAX_PHASES];
+    uint32_t chunks[MAX_PHASES];            // Chunks phase j is split into
+    uint32_t reserved1;
+} TableTask;
+
+// 'num_chunks' chunks of a phase, or one clean up segment, starting at 'start'
+typedef struct TableEntry {
+    int64_t start;                  // Ticks from the start of the hyperperiod
+    uint32_t length;                // Ticks
+    uint16_t task;                  // Index into the task table
+    uint8_t phase;
+    uint8_t kind;                   // TableEntryKind
+    uint32_t first_chunk;           // Chunk: first chunk of the run; clean up: chunks of the phase already run
+    uint32_t num_chunks;            // Chunks in the run (0 for clean up)
+} TableEntry;
+
+static_assert(sizeof(ScheduleTableHeader) == 64, "table header layout");
+static_assert(sizeof(TableTask) == 168, "table task layout");
+static_assert(sizeof(TableEntry) == 24, "table entry layout");
+
+// What runs at one instant
+typedef struct TableSlot {
+    TableEntryKind kind = TABLE_IDLE;
+    int task = -1;                  // Index into the task table
+    int phase = -1;
+    int chunk = -1;                 // Chunk being run, or chunks of the phase already run for clean up
+    Ticks start = 0;                // The chunk, clean up segment or idle gap containing the instant,
+    Ticks end = 0;                  // in ticks from the start of its hyperperiod
+} TableSlot;
+
+typedef struct ScheduleTableStats {
+    Ticks hyperperiod = 0;
+    long long jobs = 0;
+    long long segments = 0;         // Chunks and clean up segments dispatched
+    long long entries = 0;          // Entries after run-length encoding
+    long long preemptions = 0;
+    Ticks busy = 0;                 // Ticks that are not idle
+} ScheduleTableStats;
+
+// Streams a table to a file; entries are merged into runs as they arrive
+class ScheduleTableWriter {
+public:
+    ScheduleTableWriter() = default;
+    ~ScheduleTableWriter();
+    ScheduleTableWriter(const ScheduleTableWriter&) = delete;
+    ScheduleTableWriter& operator=(const ScheduleTableWriter&) = delete;
+
+    bool open(const char* path, const std::vector<TableTask>& tasks, Ticks ticks_per_unit, Ticks hyperperiod);
+
+    // Appends one chunk (num_chunks = 1) or clean up segment; must start at or after the end of the previous one
+    bool append(const TableEntry& entry);
+
+    // Writes the pending run and the final header; false if any write failed
+    bool close();
+
+    long long count() const { return entries_; }
+
+private:
+    bool flush_pending();
+
+    std::FILE* file_ = nullptr;
+    ScheduleTableHeader header_;
+    bool failed_ = false;
+    bool has_pending_ = false;
+    TableEntry pending_;
+    long long entries_ = 0;
+};
+
+// Read-only memory mapping of a table
+class ScheduleTableReader {
+public:
+    ScheduleTableReader() = default;
+    ~ScheduleTableReader();
+    ScheduleTableReader(const ScheduleTableReader&) = delete;
+    ScheduleTableReader& operator=(const ScheduleTableReader&) = delete;
+
+    // False with a description in *error if the file is missing, unfinished or not a valid table
+    bool open(const char* path, std::string* error);
+    void close();
+
+    // What runs at tick t (any t >= 0; the table repeats every hyperperiod), by binary search over the entries
+    TableSlot lookup(Ticks t) const;
+
+    Ticks hyperperiod() const { return header_ != nullptr ? header_->hyperperiod : 0; }
+    Ticks ticks_per_unit() const { return header_ != nullptr ? header_->ticks_per_unit : 0; }
+    std::size_t num_tasks() const { return header_ != nullptr ? header_->num_tasks : 0; }
+    std::size_t size() const { return header_ != nullptr ? header_->num_entries : 0; }
+    const TableTask& task(std::size_t i) const { return tasks_[i]; }
+    const TableEntry& operator[](std::size_t k) const { return entries_[k]; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    std::size_t length_ = 0;
+    const ScheduleTableHeader* header_ = nullptr;
+    const TableTask* tasks_ = nullptr;
+    const TableEntry* entries_ = nullptr;
+};
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Least common multiple of the tick periods; false if it exceeds TimeTraits<Ticks>::horizon()
+bool compute_hyperperiod(const TickTask* tasks, std::size_t num_tasks, Ticks* hyperperiod);
+
+// Synthesizes the table of tasks[0 .. num_tasks) with phase j of task i split into
+// chunks[i * MAX_PHASES + j] chunks and writes it to 'path'. Fails with a description in *error if a
+// deadline is after its period, the hyperperiod holds more than max_jobs jobs, a segment does not fit
+// the entry format, or a job misses its deadline in the table.
+bool write_schedule_table(const char* path, const TickTask* tasks, std::size_t num_tasks, const int* chunks,
+                          Ticks ticks_per_unit, std::string* error, ScheduleTableStats* stats = nullptr,
+                          long long max_jobs = TABLE_MAX_JOBS);
+
+// Converts a task set to ticks (convert_to_ticks()), runs the tick analysis for the chunk counts and
+// writes its table; fails if the tick task set is not schedulable
+bool write_schedule_table(const char* path, const std::vector<Tasks>& tasks, Ticks ticks_per_unit, TestingBound bound,
+                          std::string* error, ScheduleTableStats* stats = nullptr, long long max_jobs = TABLE_MAX_JOBS);
+
+// Name of an entry kind, e.g. "cleanup_preempt"
+const char* table_entry_kind_name(TableEntryKind kind);
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef MULTI_PHASE_TASKS_H
 #define MULTI_PHASE_TASKS_H
 
+#include "multi_phase_time.h"
+
 // =================
 // MACRO DEFINITIONS
 // =================
@@ -9,6 +11,9 @@
 #define NUM_TASKSETS 10
 #define NUM_TASKS 4
 #define NUM_PHASES 4
+
+// Maximum number of phases (capacity of the per-phase parameter arrays)
+#define MAX_PHASES 7
 // =============================
 // ABSTRACT DATATYPE DEFINITIONS
 // =============================
@@ -24,7 +29,50 @@ typedef struct Tasks{
     double ptrust = 0.0;        // Probability that this task is trusted
                                 // (i.e., this is a potential victim task,needing to perform clean-up operations).
     int num_jobs = 0;           // Number of jobs in floor_upper_bound_t interval
-    int phases = NUM_PHASES;             // Number of security phases in the task - Currently assume all phases have same wcet and cleanup
+    int phases = NUM_PHASES;             // Number of security phases in the task
+    bool uniform_phases = true;          // All phases share wcet and cleanup; the per-phase arrays are unused
+    double phase_wcets[MAX_PHASES] = {};     // WCET of phase j (only when uniform_phases is false)
+    double phase_cleanups[MAX_PHASES] = {};  // Clean up cost of phase j (only when uniform_phases is false)
 } Tasks;
 
+// Task with its timing parameters in an exact time type (multi_phase_time.h), e.g. integer clock ticks
+template <class Time>
+struct BasicTask {
+    int id = 0;
+    Time period = Time();
+    Time deadline = Time();
+    Time wcet = Time();
+    Time cleanup = Time();
+    int phases = NUM_PHASES;
+    bool uniform_phases = true;
+    Time phase_wcets[MAX_PHASES] = {};
+    Time phase_cleanups[MAX_PHASES] = {};
+};
+
+typedef BasicTask<Ticks> TickTask;
+
+// =====================
+// FUNCTION DEFINITIONS
+// =====================
+
+// WCET bound of phase j. With uniform phases only the job WCET is known, and the analysis uses it for every phase.
+inline double task_phase_wcet(const Tasks& task, int j) {
+    return task.uniform_phases ? task.wcet : task.phase_wcets[j];
+}
+
+// Clean up cost charged when phase j is preempted or completes
+inline double task_phase_cleanup(const Tasks& task, int j) {
+    return task.uniform_phases ? task.cleanup : task.phase_cleanups[j];
+}
+
+template <class Time>
+inline Time task_phase_wcet(const BasicTask<Time>& task, int j) {
+    return task.uniform_phases ? task.wcet : task.phase_wcets[j];
+}
+
+template <class Time>
+inline Time task_phase_cleanup(const BasicTask<Time>& task, int j) {
+    return task.uniform_phases ? task.cleanup : task.phase_cleanups[j];
+}
+
 #endif
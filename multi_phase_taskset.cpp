@@ -0,0 +1,96 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "multi_phase_taskset.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+void load_taskset(const std::vector<Tasks>& tasks, TaskSet& taskset) {
+    load_taskset(tasks.data(), tasks.size(), taskset);
+}
+
+#if defined(__AVX2__)
+
+// Job counts of four tasks per iteration; tasks with Di > td are masked out exactly like
+// compute_max_blocking does. The four terms are added in task order, as the scalar version and
+// taskset_dbf_points() add them, so every path returns the same bits.
+
+double taskset_dbf(const TaskSet& taskset, double td) {
+
+    const double* period = taskset.period.data();
+    const double* deadline = taskset.deadline.data();
+    const double* wcet = taskset.wcet.data();
+
+    __m256d t = _mm256_set1_pd(td);
+    __m256d one = _mm256_set1_pd(1.0);
+    __m256d zero = _mm256_setzero_pd();
+    alignas(TASKSET_ALIGNMENT) double terms[TASKSET_LANES];
+    double sum = 0.0;
+
+    for (std::size_t i = 0; i < taskset.padded_size(); i += TASKSET_LANES) {
+        __m256d d = _mm256_load_pd(deadline + i);
+        __m256d jobs = _mm256_floor_pd(_mm256_div_pd(_mm256_sub_pd(t, d), _mm256_load_pd(period + i)));
+        jobs = _mm256_max_pd(_mm256_add_pd(jobs, one), zero);
+        __m256d active = _mm256_cmp_pd(d, t, _CMP_LE_OQ);
+        _mm256_store_pd(terms, _mm256_and_pd(active, _mm256_mul_pd(jobs, _mm256_load_pd(wcet + i))));
+        for (int lane = 0; lane < TASKSET_LANES; lane++) {
+            sum += terms[lane];
+        }
+    }
+    return sum;
+}
+
+// Four time points per iteration, streaming once over the task arrays for each group of points
+
+void taskset_dbf_points(const TaskSet& taskset, const double* tds, double* out, std::size_t count) {
+
+    __m256d one = _mm256_set1_pd(1.0);
+    __m256d zero = _mm256_setzero_pd();
+
+    std::size_t k = 0;
+    for (; k + TASKSET_LANES <= count; k += TASKSET_LANES) {
+        __m256d t = _mm256_loadu_pd(tds + k);
+        __m256d sum = _mm256_setzero_pd();
+        for (std::size_t i = 0; i < taskset.size(); i++) {
+            __m256d d = _mm256_set1_pd(taskset.deadline[i]);
+            __m256d jobs = _mm256_floor_pd(_mm256_div_pd(_mm256_sub_pd(t, d), _mm256_set1_pd(taskset.period[i])));
+            jobs = _mm256_max_pd(_mm256_add_pd(jobs, one), zero);
+            __m256d active = _mm256_cmp_pd(d, t, _CMP_LE_OQ);
+            sum = _mm256_add_pd(sum, _mm256_and_pd(active, _mm256_mul_pd(jobs, _mm256_set1_pd(taskset.wcet[i]))));
+        }
+        _mm256_storeu_pd(out + k, sum);
+    }
+    for (; k < count; k++) {
+        out[k] = taskset_dbf(taskset, tds[k]);
+    }
+}
+
+#else
+
+// Scalar fallback, same formula as compute_dbf
+
+double taskset_dbf(const TaskSet& taskset, double td) {
+
+    const double* period = taskset.period.data();
+    const double* deadline = taskset.deadline.data();
+    const double* wcet = taskset.wcet.data();
+
+    double sum = 0.0;
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        if (deadline[i] <= td) {
+            sum += std::max(std::floor((td - deadline[i]) / period[i]) + 1, 0.0) * wcet[i];
+        }
+    }
+    return sum;
+}
+
+void taskset_dbf_points(const TaskSet& taskset, const double* tds, double* out, std::size_t count) {
+    for (std::size_t k = 0; k < count; k++) {
+        out[k] = taskset_dbf(taskset, tds[k]);
+    }
+}
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef MULTI_PHASE_TASKSET_H
+#define MULTI_PHASE_TASKSET_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "multi_phase_tasks.h"
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Alignment (bytes) and lane count of the task arrays; 32 bytes = one AVX2 register of doubles
+#define TASKSET_ALIGNMENT 32
+#define TASKSET_LANES 4
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Allocator handing out TASKSET_ALIGNMENT aligned storage through the aligned operator new
+template <class T>
+struct AlignedAllocator {
+    typedef T value_type;
+
+    AlignedAllocator() = default;
+    template <class U> AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(TASKSET_ALIGNMENT)));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t(TASKSET_ALIGNMENT)); }
+
+    template <class U> bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <class U> bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+typedef std::vector<double, AlignedAllocator<double>> AlignedDoubles;
+
+// Structure-of-arrays copy of the fields the demand-bound analysis reads. The arrays are padded
+// to a multiple of TASKSET_LANES with neutral tasks (deadline never reached, zero wcet), so kernels
+// never need a remainder loop.
+template <class Time>
+struct BasicTaskSet {
+    typedef Time time_type;
+    typedef std::vector<Time, AlignedAllocator<Time>> Array;
+
+    std::size_t num_tasks = 0;  // Number of real tasks
+    Array period;
+    Array deadline;
+    Array wcet;
+    Array cleanup;
+
+    std::size_t size() const { return num_tasks; }
+    std::size_t padded_size() const { return period.size(); }
+};
+
+typedef BasicTaskSet<double> TaskSet;
+typedef BasicTaskSet<Ticks> TickTaskSet;
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Copies the task parameters into 'taskset', reusing its storage
+void load_taskset(const std::vector<Tasks>& tasks, TaskSet& taskset);
+template <class Task, class Time>
+void load_taskset(const Task* tasks, std::size_t num_tasks, BasicTaskSet<Time>& taskset);
+
+// Appends one task in the next free slot (growing the padding by TASKSET_LANES when full); returns its slot
+template <class Task, class Time>
+std::size_t taskset_append(BasicTaskSet<Time>& taskset, const Task& task);
+
+// Removes the task in 'slot' by moving the last task into it
+template <class Time>
+void taskset_remove(BasicTaskSet<Time>& taskset, std::size_t slot);
+
+// Task set demand dbf(td) = sum over tasks with Di <= td of max(floor((td - Di) / Ti) + 1, 0) * Ci.
+// The double overloads are the vectorized kernels; the templates are the scalar (exact) versions.
+double taskset_dbf(const TaskSet& taskset, double td);
+template <class Time>
+Time taskset_dbf(const BasicTaskSet<Time>& taskset, Time td);
+
+// dbf at 'count' time points at once: out[k] = taskset_dbf(taskset, tds[k])
+void taskset_dbf_points(const TaskSet& taskset, const double* tds, double* out, std::size_t count);
+template <class Time>
+void taskset_dbf_points(const BasicTaskSet<Time>& taskset, const Time* tds, Time* out, std::size_t count);
+
+// ====================
+// TEMPLATE DEFINITIONS
+// ====================
+
+// assign() keeps the existing capacity, so reloading a task set of the same or smaller size does not allocate
+
+template <class Task, class Time>
+void load_taskset(const Task* tasks, std::size_t num_tasks, BasicTaskSet<Time>& taskset) {
+
+    std::size_t padded = (num_tasks + TASKSET_LANES - 1) / TASKSET_LANES * TASKSET_LANES;
+
+    taskset.num_tasks = num_tasks;
+    taskset.period.assign(padded, TimeTraits<Time>::unit());
+    taskset.deadline.assign(padded, TimeTraits<Time>::never());
+    taskset.wcet.assign(padded, TimeTraits<Time>::zero());
+    taskset.cleanup.assign(padded, TimeTraits<Time>::zero());
+
+    for (std::size_t i = 0; i < num_tasks; i++) {
+        taskset.period[i] = tasks[i].period;
+        taskset.deadline[i] = tasks[i].deadline;
+        taskset.wcet[i] = tasks[i].wcet;
+        taskset.cleanup[i] = tasks[i].cleanup;
+    }
+}
+
+template <class Task, class Time>
+std::size_t taskset_append(BasicTaskSet<Time>& taskset, const Task& task) {
+
+    if (taskset.num_tasks == taskset.padded_size()) {
+        std::size_t padded = taskset.padded_size() + TASKSET_LANES;
+        taskset.period.resize(padded, TimeTraits<Time>::unit());
+        taskset.deadline.resize(padded, TimeTraits<Time>::never());
+        taskset.wcet.resize(padded, TimeTraits<Time>::zero());
+        taskset.cleanup.resize(padded, TimeTraits<Time>::zero());
+    }
+
+    std::size_t slot = taskset.num_tasks++;
+    taskset.period[slot] = task.period;
+    taskset.deadline[slot] = task.deadline;
+    taskset.wcet[slot] = task.wcet;
+    taskset.cleanup[slot] = task.cleanup;
+    return slot;
+}
+
+template <class Time>
+void taskset_remove(BasicTaskSet<Time>& taskset, std::size_t slot) {
+
+    std::size_t last = --taskset.num_tasks;
+    taskset.period[slot] = taskset.period[last];
+    taskset.deadline[slot] = taskset.deadline[last];
+    taskset.wcet[slot] = taskset.wcet[last];
+    taskset.cleanup[slot] = taskset.cleanup[last];
+
+    taskset.period[last] = TimeTraits<Time>::unit();
+    taskset.deadline[last] = TimeTraits<Time>::never();
+    taskset.wcet[last] = TimeTraits<Time>::zero();
+    taskset.cleanup[last] = TimeTraits<Time>::zero();
+}
+
+// Job counts come from floor_div, so on exact time types this is pure integer arithmetic
+
+template <class Time>
+Time taskset_dbf(const BasicTaskSet<Time>& taskset, Time td) {
+    Time sum = TimeTraits<Time>::zero();
+    for (std::size_t i = 0; i < taskset.size(); i++) {
+        if (taskset.deadline[i] <= td) {
+            long long jobs = TimeTraits<Time>::floor_div(td - taskset.deadline[i], taskset.period[i]) + 1;
+            sum += TimeTraits<Time>::scale(jobs, taskset.wcet[i]);
+        }
+    }
+    return sum;
+}
+
+template <class Time>
+void taskset_dbf_points(const BasicTaskSet<Time>& taskset, const Time* tds, Time* out, std::size_t count) {
+    for (std::size_t k = 0; k < count; k++) {
+        out[k] = taskset_dbf(taskset, tds[k]);
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef MULTI_PHASE_TIME_H
+#define MULTI_PHASE_TIME_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Default number of fractional bits of FixedPoint time values
+#define FIXED_POINT_FRAC_BITS 16
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+// Integer number of clock ticks; verdicts computed on ticks are exact and reproducible
+typedef int64_t Ticks;
+
+// Signed fixed-point time value with FRAC_BITS fractional bits. Internally this is a tick count with
+// a resolution of 2^-FRAC_BITS time units, so the analysis on it is exact like on Ticks.
+template <int FRAC_BITS>
+struct FixedPoint {
+    int64_t raw = 0;
+
+    FixedPoint() = default;
+    static FixedPoint from_raw(int64_t raw) { FixedPoint f; f.raw = raw; return f; }
+    static FixedPoint from_double(double value) { return from_raw(int64_t(std::llround(std::ldexp(value, FRAC_BITS)))); }
+    double to_double() const { return std::ldexp(double(raw), -FRAC_BITS); }
+
+    FixedPoint operator+(FixedPoint other) const { return from_raw(raw + other.raw); }
+    FixedPoint operator-(FixedPoint other) const { return from_raw(raw - other.raw); }
+    FixedPoint& operator+=(FixedPoint other) { raw += other.raw; return *this; }
+    FixedPoint& operator-=(FixedPoint other) { raw -= other.raw; return *this; }
+    bool operator<(FixedPoint other) const { return raw < other.raw; }
+    bool operator>(FixedPoint other) const { return raw > other.raw; }
+    bool operator<=(FixedPoint other) const { return raw <= other.raw; }
+    bool operator>=(FixedPoint other) const { return raw >= other.raw; }
+    bool operator==(FixedPoint other) const { return raw == other.raw; }
+    bool operator!=(FixedPoint other) const { return raw != other.raw; }
+};
+
+// Operations the analysis core needs from a time type. Time is always analysed on a grid:
+// unit() is one grid step, and deadlines are rounded up to the grid (a no-op for exact types).
+template <class Time>
+struct TimeTraits;
+
+// Real-valued time; deadline points are the integers, as in the original analysis
+template <>
+struct TimeTraits<double> {
+    static constexpr bool exact = false;
+    static double zero() { return 0.0; }
+    static double unit() { return 1.0; }
+    static double never() { return std::numeric_limits<double>::infinity(); }
+    static double horizon() { return double(std::numeric_limits<int>::max()); } // Points stay int-sized
+    static double grid_ceil(double t) { return std::ceil(t); }
+    static double grid_floor(double t) { return std::floor(t); }
+    static long long floor_div(double a, double b) { return (long long)(std::floor(a / b)); }
+    static long long ceil_div(double a, double b) { return (long long)(std::ceil(a / b)); }
+    static double scale(long long k, double t) { return k * t; }
+    static double to_double(double t) { return t; }
+    static double from_double(double t) { return t; }
+};
+
+// Integer ticks
+template <>
+struct TimeTraits<Ticks> {
+    static constexpr bool exact = true;
+    static Ticks zero() { return 0; }
+    static Ticks unit() { return 1; }
+    static Ticks never() { return std::numeric_limits<Ticks>::max(); }
+    static Ticks horizon() { return Ticks(1) << 62; }
+    static Ticks grid_ceil(Ticks t) { return t; }
+    static Ticks grid_floor(Ticks t) { return t; }
+    static long long floor_div(Ticks a, Ticks b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+    static long long ceil_div(Ticks a, Ticks b) { return a / b + ((a % b != 0) && ((a < 0) == (b < 0))); }
+    static Ticks scale(long long k, Ticks t) { return k * t; }
+    static double to_double(Ticks t) { return double(t); }
+    static Ticks from_double(double t) { return Ticks(std::floor(t)); }
+};
+
+// Fixed point, analysed on its raw tick grid
+template <int FRAC_BITS>
+struct TimeTraits<FixedPoint<FRAC_BITS>> {
+    typedef FixedPoint<FRAC_BITS> Fixed;
+    static constexpr bool exact = true;
+    static Fixed zero() { return Fixed::from_raw(0); }
+    static Fixed unit() { return Fixed::from_raw(1); }
+    static Fixed never() { return Fixed::from_raw(std::numeric_limits<int64_t>::max()); }
+    static Fixed horizon() { return Fixed::from_raw(int64_t(1) << 62); }
+    static Fixed grid_ceil(Fixed t) { return t; }
+    static Fixed grid_floor(Fixed t) { return t; }
+    static long long floor_div(Fixed a, Fixed b) { return TimeTraits<Ticks>::floor_div(a.raw, b.raw); }
+    static long long ceil_div(Fixed a, Fixed b) { return TimeTraits<Ticks>::ceil_div(a.raw, b.raw); }
+    static Fixed scale(long long k, Fixed t) { return Fixed::from_raw(k * t.raw); }
+    static double to_double(Fixed t) { return t.to_double(); }
+    static Fixed from_double(double t) { return Fixed::from_raw(int64_t(std::floor(std::ldexp(t, FRAC_BITS)))); }
+};
+
+#endif
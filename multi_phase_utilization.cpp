@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include "multi_phase_utilization.h"
+
+UtilizationSampler::UtilizationSampler(UtilizationAlgorithm algorithm, int num_tasks, double total) {
+    prepare(algorithm, num_tasks, total);
+}
+
+void UtilizationSampler::prepare(UtilizationAlgorithm algorithm, int num_tasks, double total) {
+
+    assert(num_tasks >= 1 && total > 0.0);
+    assert(algorithm == UTIL_UUNIFAST_DISCARD || algorithm == UTIL_RANDFIXEDSUM ? total < num_tasks : total < 1.0);
+    if (algorithm == algorithm_ && num_tasks == num_tasks_ && total == total_) {
+        return;
+    }
+    algorithm_ = algorithm;
+    num_tasks_ = num_tasks;
+    total_ = total;
+
+    exponents_.resize(num_tasks);
+    draws_.resize(num_tasks);
+    values_.resize(num_tasks);
+    // UUniFast keeps (n - 1 - i) shares behind draw i, so its exponent is 1 / (n - 1 - i); the original
+    // generator used 1 / (n - i), which shrinks the early shares, and the rounded variant keeps that
+    int behind = algorithm == UTIL_UUNIFAST_ROUNDED ? 0 : 1;
+    for (int i = 0; i < num_tasks - 1; i++) {
+        exponents_[i] = 1.0 / (num_tasks - i - behind);
+    }
+
+    // UUniFast-Discard needs the table for its fallback as well
+    randfixedsum_ready_ = false;
+    if (algorithm == UTIL_RANDFIXEDSUM || algorithm == UTIL_UUNIFAST_DISCARD) {
+        build_randfixedsum_table();
+    }
+}
+
+void UtilizationSampler::sample(GeneratorContext& ctx, double* out) {
+
+    switch (algorithm_) {
+        case UTIL_UUNIFAST_ROUNDED:
+            sample_uunifast(ctx, out, true);
+            break;
+        case UTIL_UUNIFAST:
+            sample_uunifast(ctx, out, false);
+            break;
+        case UTIL_UUNIFAST_DISCARD:
+            for (int attempt = 0; attempt < UUNIFAST_DISCARD_MAX_ATTEMPTS; attempt++) {
+                sample_uunifast(ctx, out, false);
+                if (*std::max_element(out, out + num_tasks_) < 1.0) {
+                    return;
+                }
+            }
+            discard_fallbacks_++;
+            sample_randfixedsum(ctx, out);
+            break;
+        case UTIL_RANDFIXEDSUM:
+            sample_randfixedsum(ctx, out);
+            break;
+    }
+}
+
+const double* UtilizationSampler::sample(GeneratorContext& ctx) {
+    sample(ctx, values_.data());
+    return values_.data();
+}
+
+void UtilizationSampler::sample_batch(GeneratorContext& ctx, long long count, double* out) {
+    for (long long k = 0; k < count; k++) {
+        sample(ctx, out + k * num_tasks_);
+    }
+}
+
+// UUniFast [1] with the three steps in separate loops: the random draws (sequential in the engine),
+// the powers u_i^exponent_i (independent, so the compiler can vectorize them) and the running sum.
+// The draws are taken in the same order as by generate_task_utilizations(), so the rounded variant
+// reproduces it exactly.
+
+void UtilizationSampler::sample_uunifast(GeneratorContext& ctx, double* out, bool rounded) {
+
+    const int n = num_tasks_;
+    double* factors = draws_.data();
+    const double* exponents = exponents_.data();
+    for (int i = 0; i < n - 1; i++) {
+        factors[i] = ctx.uniform();
+    }
+    for (int i = 0; i < n - 1; i++) {
+        factors[i] = std::pow(factors[i], exponents[i]);
+    }
+
+    double sum_util = total_;
+    for (int i = 0; i < n - 1; i++) {
+        double rem_sum_util = sum_util * factors[i];
+        out[i] = sum_util - rem_sum_util;
+        sum_util = rem_sum_util;
+    }
+    out[n - 1] = sum_util;
+
+    if (rounded) {
+        for (int i = 0; i < n; i++) {
+            out[i] = std::round(out[i] * 100) / 100.0;
+        }
+    }
+}
+
+// Transition probabilities of RandFixedSum [10] for shares in [0, 1] (Stafford's randfixedsum.m with
+// a = 0, b = 1). w holds the scaled volumes of the simplex slices; only two of its rows are live.
+
+void UtilizationSampler::build_randfixedsum_table() {
+
+    const int n = num_tasks_;
+    const double tiny = std::ldexp(1.0, -1074);
+    int k = std::max(std::min(int(std::floor(total_)), n - 1), 0);
+    double s = std::max(std::min(total_, double(k + 1)), double(k));
+    rfs_k_ = k;
+    rfs_s_ = s;
+
+    // s1(c) = s - (k - c + 1) and s2(c) = (k + n - c + 1) - s for c = 1 .. n
+    std::vector<double> s1(n + 1), s2(n + 1);
+    for (int c = 1; c <= n; c++) {
+        s1[c] = s - (k - c + 1);
+        s2[c] = (k + n - c + 1) - s;
+    }
+
+    std::vector<double> previous(n + 2, 0.0), current(n + 2, 0.0);
+    previous[2] = DBL_MAX;
+    transition_.assign(std::size_t(std::max(n - 1, 0)) * n, 0.0);
+    for (int i = 2; i <= n; i++) {
+        std::fill(current.begin(), current.end(), 0.0);
+        for (int c = 1; c <= i; c++) {
+            double tmp1 = previous[c + 1] * s1[c] / i;
+            double tmp2 = previous[c] * s2[n - i + c] / i;
+            current[c + 1] = tmp1 + tmp2;
+            double tmp3 = current[c + 1] + tiny;
+            bool upper = s2[n - i + c] > s1[c];
+            transition_[std::size_t(i - 2) * n + (c - 1)] = upper ? tmp2 / tmp3 : 1.0 - tmp1 / tmp3;
+        }
+        std::swap(previous, current);
+    }
+    randfixedsum_ready_ = true;
+}
+
+void UtilizationSampler::sample_randfixedsum(GeneratorContext& ctx, double* out) {
+
+    assert(randfixedsum_ready_);
+    const int n = num_tasks_;
+    double s = rfs_s_;
+    int j = rfs_k_ + 1;
+    double sm = 0.0;
+    double pr = 1.0;
+    for (int i = n - 1; i >= 1; i--) {
+        int e = ctx.uniform() <= transition_[std::size_t(i - 1) * n + (j - 1)] ? 1 : 0;
+        double sx = std::pow(ctx.uniform(), 1.0 / i);
+        sm += (1.0 - sx) * pr * s / (i + 1);
+        pr *= sx;
+        out[n - i - 1] = sm + pr * e;
+        s -= e;
+        j -= e;
+    }
+    out[n - 1] = sm + pr * s;
+
+    // The construction orders the shares; a uniform shuffle makes every position identically distributed
+    for (int i = n - 1; i > 0; i--) {
+        int r = int(ctx.uniform() * (i + 1));
+        std::swap(out[i], out[r]);
+    }
+}
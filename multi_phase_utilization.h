@@ -0,0 +1,82 @@
+#ifndef MULTI_PHASE_UTILIZATION_H
+#define MULTI_PHASE_UTILIZATION_H
+
+#include <vector>
+#include "generator_context.h"
+
+// Task utilization vectors with a fixed total. The original generator (UUniFast with every share
+// rounded to 0.01) is kept for reproducibility; the other algorithms do not round, so the shares
+// sum to the requested total and no task ends up with utilization 0. UUniFast-Discard and
+// RandFixedSum also support totals above 1 for multiprocessor task sets.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Algorithm used by GeneratorParams when none is selected explicitly
+#define UTILIZATION_ALGORITHM UTIL_UUNIFAST_ROUNDED
+
+// Draws UUniFast-Discard makes before it falls back to RandFixedSum for that vector
+#define UUNIFAST_DISCARD_MAX_ATTEMPTS 1000
+
+// =============================
+// ABSTRACT DATATYPE DEFINITIONS
+// =============================
+
+typedef enum {
+    UTIL_UUNIFAST_ROUNDED,      // The original generator: UUniFast [1] with exponents off by one, shares rounded to 0.01; total < 1
+    UTIL_UUNIFAST,              // UUniFast [1] without rounding; total < 1
+    UTIL_UUNIFAST_DISCARD,      // UUniFast, redrawn while any share exceeds 1 [9]; total < num_tasks
+    UTIL_RANDFIXEDSUM           // RandFixedSum [10]: uniform over all share vectors in [0, 1]^n with the total
+} UtilizationAlgorithm;
+
+// Draws utilization vectors for one (algorithm, task count, total). Everything that only depends on
+// those three - the UUniFast exponents and the O(n^2) RandFixedSum transition table - is computed by
+// prepare() and reused by every draw, so a worker keeps one sampler and batches cost O(n) per vector.
+class UtilizationSampler {
+public:
+    UtilizationSampler() = default;
+    UtilizationSampler(UtilizationAlgorithm algorithm, int num_tasks, double total);
+
+    // Rebuilds the tables unless they already match
+    void prepare(UtilizationAlgorithm algorithm, int num_tasks, double total);
+
+    // num_tasks shares summing to the total into out[0 .. num_tasks)
+    void sample(GeneratorContext& ctx, double* out);
+
+    // Same into the sampler's own buffer, valid until the next draw
+    const double* sample(GeneratorContext& ctx);
+
+    // 'count' vectors back to back into out[0 .. count * num_tasks)
+    void sample_batch(GeneratorContext& ctx, long long count, double* out);
+
+    UtilizationAlgorithm algorithm() const { return algorithm_; }
+    int num_tasks() const { return num_tasks_; }
+    double total() const { return total_; }
+
+    // UUniFast-Discard vectors that hit UUNIFAST_DISCARD_MAX_ATTEMPTS and were drawn by RandFixedSum
+    long long discard_fallbacks() const { return discard_fallbacks_; }
+
+private:
+    void sample_uunifast(GeneratorContext& ctx, double* out, bool rounded);
+    void sample_randfixedsum(GeneratorContext& ctx, double* out);
+    void build_randfixedsum_table();
+
+    UtilizationAlgorithm algorithm_ = UTILIZATION_ALGORITHM;
+    int num_tasks_ = 0;
+    double total_ = 0.0;
+    bool randfixedsum_ready_ = false;
+    long long discard_fallbacks_ = 0;
+
+    std::vector<double> exponents_;     // UUniFast exponent of draw i
+    std::vector<double> draws_;         // Uniform draws of one vector, turned into the UUniFast factors in place
+    std::vector<double> values_;        // Output of sample(ctx)
+    std::vector<double> transition_;    // RandFixedSum table t(i, j) at [(i - 1) * n + (j - 1)]
+    int rfs_k_ = 0;                     // floor of the scaled total, clamped to [0, n - 1]
+    double rfs_s_ = 0.0;                // Scaled total clamped to [k, k + 1]
+};
+
+// [9] R. Davis, A. Burns, "Improved priority assignment for global fixed priority pre-emptive scheduling in multiprocessor real-time systems", RTS 47(1), 2011
+// [10] P. Emberson, R. Stafford, R. Davis, "Techniques for the synthesis of multiprocessor tasksets", WATERS 2010
+
+#endif
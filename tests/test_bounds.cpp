@@ -0,0 +1,165 @@
+#include <climits>
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_core.h"
+#include "test_support.h"
+
+static AnalysisScratch scratch;
+
+static bool schedulable(const std::vector<Tasks>& tasks, TestingBound bound) {
+    return analyze_taskset(tasks.data(), tasks.size(), bound, scratch);
+}
+
+// Hand-computed task sets. Deadlines are half-integers, so every deadline point ceil(k*Ti + Di) lies
+// strictly after the deadlines it counts.
+
+static void check_known_answers() {
+    const TestingBound sufficient[] = {BOUND_BUSY_PERIOD, BOUND_LA_LB, BOUND_QPA};
+
+    // dbf(5) = 4 <= 5, and every later point has more slack
+    std::vector<Tasks> fits = {test_task(0, 10, 4.5, 4)};
+    // dbf(3) = 3.5 > 3 inside the beta window
+    std::vector<Tasks> window_overload = {test_task(0, 10, 2.5, 3.5), test_task(1, 20, 6.5, 1)};
+    // U = 0.9375 and nothing fails up to max(D_i), but dbf(6) = 2 * 1.5 + 3.5 = 6.5 > 6
+    std::vector<Tasks> late_overload = {test_task(0, 3, 2.5, 1.5), test_task(1, 8, 4.5, 3.5)};
+    // U = 1, busy period 15 and La undefined: dbf(9) = 3 * 1.5 + 2 * 2.5 = 9.5 > 9
+    std::vector<Tasks> full_overload = {test_task(0, 3, 2.5, 1.5), test_task(1, 5, 3.5, 2.5)};
+
+    for (TestingBound bound : sufficient) {
+        CHECK(schedulable(fits, bound));
+        CHECK(!schedulable(window_overload, bound));
+        CHECK(!schedulable(late_overload, bound));
+        CHECK(!schedulable(full_overload, bound));
+    }
+    // The legacy window stops at max(D_i) and misses both late overloads
+    CHECK(!schedulable(window_overload, BOUND_MAX_DEADLINE));
+    CHECK(schedulable(late_overload, BOUND_MAX_DEADLINE));
+    CHECK(schedulable(full_overload, BOUND_MAX_DEADLINE));
+}
+
+// Deadlines on the grid: the job due at td counts at td. Two jobs of 3 due at 5 demand 6 > 5, and a
+// job of 10 due at 5 cannot fit at all; every bound rejects both at td = 5, in time units and in ticks.
+
+static void check_deadline_on_point() {
+    std::vector<Tasks> pair = {test_task(0, 20, 5, 3), test_task(1, 20, 5, 3)};
+    std::vector<Tasks> single = {test_task(0, 20, 5, 10)};
+    std::vector<TickTask> ticks;
+    TickAnalysisScratch tick_scratch;
+    CHECK(compute_max_blocking(pair, 5) == -1.0);
+    CHECK(compute_max_blocking(pair, 4) == 4.0);
+    for (const std::vector<Tasks>* tasks : {&pair, &single}) {
+        convert_to_ticks(*tasks, 1, ticks);
+        for (TestingBound bound : {BOUND_MAX_DEADLINE, BOUND_BUSY_PERIOD, BOUND_LA_LB, BOUND_QPA}) {
+            CHECK(!schedulable(*tasks, bound));
+            CHECK(scratch.result.verdict == ANALYSIS_DEMAND_EXCEEDED && scratch.result.failing_td == 5.0);
+            CHECK(!analyze_taskset(ticks.data(), ticks.size(), bound, tick_scratch));
+            CHECK(tick_scratch.result.verdict == ANALYSIS_DEMAND_EXCEEDED && tick_scratch.result.failing_td == 5);
+        }
+    }
+}
+
+// The sufficient testing bounds decide every task set alike: QPA, min(La, Lb) and the busy period
+
+static void check_bounds_agree() {
+    std::mt19937_64 rng(0xb0d5);
+    std::vector<Tasks> tasks;
+    for (int num_tasks : {2, 4, 8, 16}) {
+        for (double utilization : {0.5, 0.8, 0.95, 0.99}) {
+            for (int k = 0; k < 200; k++) {
+                random_test_tasks(rng, num_tasks, utilization, tasks);
+                bool busy = schedulable(tasks, BOUND_BUSY_PERIOD);
+                bool la_lb = schedulable(tasks, BOUND_LA_LB);
+                bool qpa = schedulable(tasks, BOUND_QPA);
+                CHECK(busy == la_lb && la_lb == qpa);
+            }
+        }
+    }
+}
+
+// Deadline points fetched in small batches are those of a single enumeration
+
+static void check_batched_points() {
+    std::mt19937_64 rng(0xba7c);
+    std::vector<Tasks> tasks;
+    std::vector<double> all, batch, joined;
+    std::vector<DeadlineEvent> heap;
+    TaskSet taskset;
+    for (int k = 0; k < 100; k++) {
+        random_test_tasks(rng, 8, 0.9, tasks);
+        load_taskset(tasks, taskset);
+        double from = std::floor(tasks[0].deadline);
+        double to = from + 5000.0;
+        enumerate_deadline_points(taskset, from, to, all, heap);
+        joined.clear();
+        start_deadline_points(taskset, from, to, heap);
+        bool more = true;
+        while (more) {
+            more = next_deadline_points(taskset, to, 7, batch, heap);
+            CHECK(batch.size() <= 7);
+            joined.insert(joined.end(), batch.begin(), batch.end());
+        }
+        CHECK(joined == all);
+    }
+}
+
+// The vectorized dbf kernels add the per-task terms in task order, so they return the same bits as
+// the scalar template, one point at a time or several at once
+
+static void check_dbf_kernels() {
+    std::mt19937_64 rng(0xdbf5);
+    std::vector<Tasks> tasks;
+    std::vector<double> points, demand;
+    TaskSet taskset;
+    for (int k = 0; k < 200; k++) {
+        random_test_tasks(rng, 1 + k % 13, 0.9, tasks);
+        load_taskset(tasks, taskset);
+        points.clear();
+        for (double td = 1.0; td < 3000.0; td += 1.0 + double(rng() % 37)) {
+            points.push_back(td);
+        }
+        demand.resize(points.size());
+        taskset_dbf_points(taskset, points.data(), demand.data(), points.size());
+        for (std::size_t p = 0; p < points.size(); p++) {
+            double exact = taskset_dbf<double>(taskset, points[p]);
+            CHECK(taskset_dbf(taskset, points[p]) == exact);
+            CHECK(demand[p] == exact);
+        }
+    }
+}
+
+// A bound past the time horizon is not cut short. With U = 1 exactly (Ui = 1/2, 1/4, 1/8, 1/8) and
+// prime periods the busy period only ends at about 1e12, and La does not exist, so no bound can
+// prove the set. At half the WCETs La = max(D_i) = 1021 proves it under every bound.
+
+static void check_clamped_bound() {
+    const double periods[] = {1009, 1013, 1019, 1021};
+    const double shares[] = {0.5, 0.25, 0.125, 0.125};
+    std::vector<Tasks> full, half;
+    for (int i = 0; i < 4; i++) {
+        full.push_back(test_task(i, periods[i], periods[i], periods[i] * shares[i]));
+        half.push_back(test_task(i, periods[i], periods[i], periods[i] * shares[i] / 2));
+    }
+    TaskSet taskset;
+    load_taskset(full, taskset);
+    CHECK(compute_demand_utilization(taskset) == 1.0);
+    CHECK(compute_la_bound(taskset) > double(INT_MAX));
+    bool clamped = false;
+    compute_testing_bound(taskset, BOUND_BUSY_PERIOD, &clamped);
+    CHECK(clamped);
+    for (TestingBound bound : {BOUND_BUSY_PERIOD, BOUND_LA_LB, BOUND_QPA}) {
+        CHECK(!schedulable(full, bound));
+        CHECK(scratch.result.verdict == ANALYSIS_BOUND_BEYOND_HORIZON);
+        CHECK(schedulable(half, bound));
+    }
+}
+
+int main() {
+    check_known_answers();
+    check_deadline_on_point();
+    check_bounds_agree();
+    check_batched_points();
+    check_dbf_kernels();
+    check_clamped_bound();
+    return test_result();
+}
@@ -0,0 +1,207 @@
+#include <cmath>
+#include <cstdio>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+#include "multi-phase.h"
+#include "test_support.h"
+
+#define CORPUS_PATH "test_corpus.mpc"
+#define CSV_PATH "test_corpus.csv"
+
+static void patch(const char* path, long offset, const void* bytes, std::size_t size) {
+    std::FILE* file = std::fopen(path, "r+b");
+    CHECK(file != nullptr);
+    std::fseek(file, offset, SEEK_SET);
+    std::fwrite(bytes, size, 1, file);
+    std::fclose(file);
+}
+
+static bool same_task(const Tasks& a, const Tasks& b) {
+    if (a.id != b.id || a.period != b.period || a.deadline != b.deadline || a.wcet != b.wcet || a.cleanup != b.cleanup ||
+        a.utilization != b.utilization || a.ptrust != b.ptrust || a.phases != b.phases || a.uniform_phases != b.uniform_phases) {
+        return false;
+    }
+    for (int j = 0; !a.uniform_phases && j < a.phases; j++) {
+        if (a.phase_wcets[j] != b.phase_wcets[j] || a.phase_cleanups[j] != b.phase_cleanups[j]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Writes task sets of varying size, some with per-phase parameters
+static void write_corpus(std::vector<std::vector<Tasks>>& written) {
+    std::mt19937_64 rng(0xc0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    TasksetWriter writer;
+    CHECK(writer.open(CORPUS_PATH, 0xc0));
+    written.clear();
+    for (int k = 0; k < 50; k++) {
+        std::vector<Tasks> tasks;
+        random_test_tasks(rng, 1 + k % 9, 0.8, tasks);
+        for (Tasks& task : tasks) {
+            if (uniform(rng) < 0.4) {
+                task.uniform_phases = false;
+                task.phases = 1 + int(uniform(rng) * MAX_PHASES);
+                for (int j = 0; j < task.phases; j++) {
+                    task.phase_wcets[j] = task.wcet / task.phases;
+                    task.phase_cleanups[j] = uniform(rng) * task.cleanup;
+                }
+            }
+        }
+        CHECK(writer.write(tasks));
+        written.push_back(tasks);
+    }
+    CHECK(writer.close());
+}
+
+// Hand-written CSV rows import field for field and keep their verdicts: {T10, D4.5, C4} fits, the
+// second set demands 7 by t = 6.5
+
+static void check_csv_import() {
+    std::FILE* csv = std::fopen(CSV_PATH, "w");
+    CHECK(csv != nullptr);
+    std::fputs("taskset,id,period,deadline,wcet,cleanup,utilization,ptrust,phases,uniform_phases,phase_wcets,phase_cleanups\n"
+               "0,1,10,4.5,4,0,0.4,0,1,1,,\n"
+               "1,2,10,2.5,3.5,0,0.35,0,1,1,,\n"
+               "1,3,20,6.5,1,0.5,0.05,0,2,0,0.25;0.75,0.25;0.25\n",
+               csv);
+    std::fclose(csv);
+    std::string error;
+    CHECK(csv_to_corpus(CSV_PATH, CORPUS_PATH, &error));
+    TasksetReader reader;
+    CHECK(reader.open(CORPUS_PATH, &error));
+    CHECK(reader.size() == 2);
+    if (reader.size() != 2 || reader[1].num_tasks != 2) {
+        return;
+    }
+    Tasks task = task_from_record(reader[1].tasks[1]);
+    CHECK(task.id == 3 && task.period == 20 && task.deadline == 6.5 && task.wcet == 1 && task.cleanup == 0.5);
+    CHECK(task.phases == 2 && !task.uniform_phases);
+    CHECK(task.phase_wcets[1] == 0.75 && task.phase_cleanups[0] == 0.25);
+    AnalysisScratch scratch;
+    CHECK(analyze_taskset(reader[0].tasks, reader[0].num_tasks, DEFAULT_TESTING_BOUND, scratch));
+    CHECK(!analyze_taskset(reader[1].tasks, reader[1].num_tasks, DEFAULT_TESTING_BOUND, scratch));
+}
+
+// Every task set reads back field for field, and analyses alike from the records and the copies
+
+static void check_round_trip() {
+    std::vector<std::vector<Tasks>> written;
+    write_corpus(written);
+    TasksetReader reader;
+    std::string error;
+    CHECK(reader.open(CORPUS_PATH, &error));
+    CHECK(reader.size() == written.size());
+    CHECK(reader.seed() == 0xc0);
+    AnalysisScratch from_records, from_tasks;
+    for (std::size_t k = 0; k < reader.size() && k < written.size(); k++) {
+        TasksetView view = reader[k];
+        CHECK(view.num_tasks == written[k].size());
+        for (std::size_t i = 0; i < view.num_tasks && i < written[k].size(); i++) {
+            CHECK(same_task(task_from_record(view.tasks[i]), written[k][i]));
+        }
+        bool expected = analyze_taskset(written[k].data(), written[k].size(), DEFAULT_TESTING_BOUND, from_tasks);
+        CHECK(analyze_taskset(view.tasks, view.num_tasks, DEFAULT_TESTING_BOUND, from_records) == expected);
+        CHECK(from_records.beta_per_task == from_tasks.beta_per_task);
+    }
+}
+
+// A file without its index (the writer did not finish) is scanned up to its last complete block
+
+static void check_unfinished() {
+    std::vector<std::vector<Tasks>> written;
+    write_corpus(written);
+    uint64_t no_index = 0;
+    patch(CORPUS_PATH, offsetof(CorpusHeader, num_tasksets), &no_index, sizeof(no_index));
+    patch(CORPUS_PATH, offsetof(CorpusHeader, index_offset), &no_index, sizeof(no_index));
+    TasksetReader reader;
+    std::string error;
+    CHECK(reader.open(CORPUS_PATH, &error));
+    CHECK(reader.size() == written.size());
+    if (reader.size() == written.size()) {
+        CHECK(same_task(task_from_record(reader[written.size() - 1].tasks[0]), written.back()[0]));
+    }
+}
+
+// Rows that would break the analysis or the replay are rejected on import: a zero period (with a
+// zero WCET it made replay hang), negative or zero parameters, non-finite values, trailing characters
+// and malformed integer fields
+
+static void check_csv_rejects() {
+    const char* rows[] = {
+        "0,1,0,10,0,0,0,0,1,1,,", "0,1,-5,10,1,0,0,0,1,1,,", "0,1,10,0,1,0,0,0,1,1,,",
+        "0,1,10,-1,1,0,0,0,1,1,,", "0,1,10,10,-1,0,0,0,1,1,,", "0,1,10,10,1,-0.5,0,0,1,1,,",
+        "0,1,nan,10,1,0,0,0,1,1,,", "0,1,10,10,inf,0,0,0,1,1,,", "0,1,10,10,1,0,nan,0,1,1,,",
+        "0,1,10x,10,1,0,0,0,1,1,,", "0,1,10,10,1,0,0,0,1,1 ,,", "0,1.5,10,10,1,0,0,0,1,1,,",
+        "0,1,10,10,1,0,0,0,,1,,", "0,1,10,10,1,0,0,0,2,0,1;-1,0;0", "0,1,10,10,1,0,0,0,2,0,1;1,0;inf",
+    };
+    for (const char* row : rows) {
+        std::FILE* csv = std::fopen(CSV_PATH, "w");
+        CHECK(csv != nullptr);
+        std::fprintf(csv, "taskset,id,period,deadline,wcet,cleanup,utilization,ptrust,phases,uniform_phases,phase_wcets,phase_cleanups\n%s\n", row);
+        std::fclose(csv);
+        std::string error;
+        CHECK(!csv_to_corpus(CSV_PATH, CORPUS_PATH, &error));
+        CHECK(error.find(":2:") != std::string::npos);
+    }
+}
+
+// Corrupt block headers and records are rejected when the file is opened
+
+static void check_corrupt() {
+    const long block = sizeof(CorpusHeader);
+    const long record = block + sizeof(CorpusBlockHeader);
+    const uint32_t huge = 1u << 30;
+    const uint16_t phases = MAX_PHASES + 1;
+    const double zero = 0.0;
+    const double negative = -5.0;
+    const double nan = std::nan("");
+    for (int corruption = 0; corruption < 7; corruption++) {
+        std::vector<std::vector<Tasks>> written;
+        write_corpus(written);
+        switch (corruption) {
+            case 0:
+                patch(CORPUS_PATH, block + offsetof(CorpusBlockHeader, num_tasks), &huge, sizeof(huge));
+                break;
+            case 1:
+                patch(CORPUS_PATH, block + offsetof(CorpusBlockHeader, block_size), &huge, sizeof(huge));
+                break;
+            case 2:
+                patch(CORPUS_PATH, record + offsetof(TaskRecord, phases), &phases, sizeof(phases));
+                break;
+            case 3:
+                for (std::size_t i = 0; i < written[0].size(); i++) {
+                    patch(CORPUS_PATH, record + long(i * sizeof(TaskRecord)) + offsetof(TaskRecord, flags), "\0", 2);
+                    patch(CORPUS_PATH, record + long(i * sizeof(TaskRecord)) + offsetof(TaskRecord, phase_offset), &huge, sizeof(huge));
+                }
+                break;
+            case 4:
+                patch(CORPUS_PATH, record + offsetof(TaskRecord, period), &zero, sizeof(zero));
+                break;
+            case 5:
+                patch(CORPUS_PATH, record + offsetof(TaskRecord, deadline), &negative, sizeof(negative));
+                break;
+            case 6:
+                patch(CORPUS_PATH, record + offsetof(TaskRecord, wcet), &nan, sizeof(nan));
+                break;
+        }
+        TasksetReader reader;
+        std::string error;
+        CHECK(!reader.open(CORPUS_PATH, &error));
+        CHECK(!error.empty());
+    }
+}
+
+int main() {
+    check_csv_import();
+    check_csv_rejects();
+    check_round_trip();
+    check_unfinished();
+    check_corrupt();
+    std::remove(CORPUS_PATH);
+    std::remove(CSV_PATH);
+    return test_result();
+}
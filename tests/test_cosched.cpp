@@ -0,0 +1,78 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "multi_phase_cosched.h"
+#include "test_support.h"
+
+// Hand-computed clean up work. A phase of 4 with a clean up of 0.5 runs in one chunk at beta 4.5 and
+// in two at beta 2.5. A trusted and an untrusted task fit on one core, where the single chunk of the
+// trusted task costs 1 / 10 of clean up; on separate cores the trusted one is isolated and pays none.
+
+static void check_known_answers() {
+    Tasks phase = test_task(0, 10, 9.5, 4, 0.5);
+    phase.phases = 1;
+    CHECK(task_is_trusted(phase));
+    CHECK(!task_is_trusted(task_without_cleanup(phase)));
+    CHECK(std::fabs(task_cleanup_utilization(phase, 4.5) - 0.05) < 1e-12);
+    CHECK(std::fabs(task_cleanup_utilization(phase, 2.5) - 0.1) < 1e-12);
+
+    std::vector<Tasks> tasks = {test_task(0, 10, 9.5, 4, 1), test_task(1, 10, 9.5, 4)};
+    tasks[0].phases = 1;
+    tasks[1].phases = 1;
+    CoScheduleResult result;
+    CHECK(co_schedule_tasks(tasks, 2, CoScheduleOptions(), &result));
+    CHECK(result.reference == COSCHED_REFERENCE_SINGLE_CORE);
+    CHECK(std::fabs(result.reference_cleanup - 0.1) < 1e-12);
+    CHECK(result.cleanup_utilization == 0.0);
+    CHECK(std::fabs(result.cleanup_saved - 0.1) < 1e-12);
+    CHECK(result.core_of_task.size() == 2);
+    if (result.core_of_task.size() == 2) {
+        CHECK(result.core_of_task[0] != result.core_of_task[1]);
+        CHECK(result.core_isolated[result.core_of_task[0]]);
+        CHECK(!result.core_isolated[result.core_of_task[1]]);
+    }
+}
+
+// Random sets with a mix of trusted and untrusted tasks: every core of a placement passes the test as
+// analysed, isolated cores hold only trusted tasks, the search never does worse than the reference, and the thread count does not matter
+
+static void check_random_placements() {
+    std::mt19937_64 rng(0xc05c);
+    std::vector<Tasks> tasks;
+    std::vector<std::vector<Tasks>> cores;
+    AnalysisScratch scratch;
+    int feasible = 0;
+    for (int k = 0; k < 30; k++) {
+        int num_cores = 2 + k % 2;
+        random_test_tasks(rng, 3 * num_cores, 0.6 * num_cores, tasks);
+        for (std::size_t i = 0; i < tasks.size(); i += 2) {
+            tasks[i].cleanup = 0.0;
+        }
+        CoScheduleOptions options;
+        options.threads = 1;
+        CoScheduleResult serial, parallel;
+        bool ok = co_schedule_tasks(tasks, num_cores, options, &serial);
+        options.threads = 4;
+        CHECK(co_schedule_tasks(tasks, num_cores, options, &parallel) == ok);
+        if (!ok) {
+            continue;
+        }
+        feasible++;
+        CHECK(parallel.core_of_task == serial.core_of_task && parallel.start == serial.start);
+        CHECK(serial.cleanup_utilization <= serial.reference_cleanup + COSCHED_EPSILON);
+        co_schedule_cores(tasks, serial, cores);
+        for (std::size_t c = 0; c < cores.size(); c++) {
+            CHECK(analyze_taskset(cores[c].data(), cores[c].size(), options.bound, scratch));
+        }
+        for (std::size_t i = 0; i < tasks.size(); i++) {
+            CHECK(!serial.core_isolated[serial.core_of_task[i]] || task_is_trusted(tasks[i]));
+        }
+    }
+    CHECK(feasible > 0);
+}
+
+int main() {
+    check_known_answers();
+    check_random_placements();
+    return test_result();
+}
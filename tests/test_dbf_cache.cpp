@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_dbf_cache.h"
+#include "test_support.h"
+
+// Hand-computed slack of {T10, D4.5, C4} and {T20, D9.5, C3}: one job of each is due by 10, three
+// of the first and one of the second by 25, and none before the first deadline
+
+static void check_known_answers() {
+    std::vector<Tasks> tasks = {test_task(0, 10, 4.5, 4), test_task(1, 20, 9.5, 3)};
+    DbfCache cache;
+    CHECK(compute_max_blocking(tasks, 4, cache) == 4.0);
+    CHECK(compute_max_blocking(tasks, 10, cache) == 3.0);
+    CHECK(compute_max_blocking(tasks, 25, cache) == 10.0);
+    CHECK(compute_max_blocking(tasks, 25, cache) == 10.0);
+    CHECK(cache.stats().hits > 0);
+
+    // Two jobs of 3 due at 5 count at 5 itself
+    std::vector<Tasks> on_point = {test_task(0, 20, 5, 3), test_task(1, 20, 5, 3)};
+    CHECK(compute_max_blocking(on_point, 5, cache) == -1.0);
+    CHECK(compute_max_blocking(on_point, 25, cache) == 13.0);
+}
+
+// analyze_taskset_cached() reaches analyze_taskset()'s verdict, failing point, betas and chunk
+// counts, on a sequence of task sets that differ in one task (cache hits) and on fresh ones, with a
+// roomy cache and with one small enough to evict on nearly every lookup
+
+static void check_against_analysis() {
+    std::mt19937_64 rng(0xdbfc);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    AnalysisScratch exact, cached;
+    DbfCache roomy;
+    DbfCache tiny(4096);
+    std::vector<Tasks> tasks, fresh;
+    for (int k = 0; k < 2000; k++) {
+        if (k % 8 == 0) {
+            random_test_tasks(rng, 8, 0.5 + 0.5 * uniform(rng), tasks);
+        } else {
+            random_test_tasks(rng, 1, 0.02 + 0.18 * uniform(rng), fresh);
+            fresh[0].id = k % 8;
+            tasks[k % 8] = fresh[0];
+        }
+        if (k % 3 == 0) {
+            // Deadlines on the grid, where the job due at a deadline point counts at the point itself
+            for (Tasks& task : tasks) {
+                task.period = std::floor(task.period);
+                task.deadline = std::max(1.0, std::floor(task.deadline));
+            }
+        }
+        for (TestingBound bound : {BOUND_MAX_DEADLINE, BOUND_BUSY_PERIOD, BOUND_LA_LB, BOUND_QPA}) {
+            bool expected = analyze_taskset(tasks.data(), tasks.size(), bound, exact);
+            for (DbfCache* cache : {&roomy, &tiny}) {
+                CHECK(analyze_taskset_cached(tasks.data(), tasks.size(), bound, *cache, cached) == expected);
+                CHECK(cached.result.verdict == exact.result.verdict);
+                CHECK(cached.result.failing_td == exact.result.failing_td);
+                CHECK(cached.beta_per_task == exact.beta_per_task);
+                CHECK(cached.intervals_per_task_phase == exact.intervals_per_task_phase);
+            }
+        }
+        for (int td = 1; td <= 200; td += 13) {
+            CHECK(compute_max_blocking(tasks, td, roomy) == compute_max_blocking(tasks, td));
+        }
+    }
+    CHECK(roomy.stats().hits > 0 && roomy.stats().evictions == 0);
+    CHECK(tiny.stats().evictions > 0 && tiny.stats().bytes <= 4096);
+}
+
+int main() {
+    check_known_answers();
+    check_against_analysis();
+    return test_result();
+}
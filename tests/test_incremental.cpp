@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_incremental.h"
+#include "test_support.h"
+
+// Betas agree up to the order in which the two analyses sum floating-point demands
+static bool same_beta(double a, double b) {
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+// Hand-computed admissions (no clean up, so beta = min(wcet, delta before D + 1))
+
+static void check_known_answers() {
+    IncrementalAnalyzer analyzer(BOUND_QPA);
+    Tasks a = test_task(0, 10, 4.5, 4);
+    Tasks b = test_task(1, 20, 9.5, 3);
+    Tasks c = test_task(2, 10, 3.5, 1.5);
+
+    // No point lies before 4.5, so A keeps beta = 4
+    CHECK(analyzer.try_admit(a));
+    CHECK(analyzer.beta(0) == 4.0);
+    // Window 9: delta(5) = 5 - 4 = 1 limits B to 2
+    CHECK(analyzer.try_admit(b));
+    CHECK(analyzer.beta(0) == 4.0);
+    CHECK(analyzer.beta(1) == 2.0);
+    // dbf(5) = 1.5 + 4 > 5
+    CHECK(!analyzer.try_admit(c));
+    CHECK(analyzer.size() == 2);
+    CHECK(analyzer.beta(1) == 2.0);
+    // Without A: delta(4) = 4 - 1.5 = 2.5 leaves B at its wcet
+    CHECK(analyzer.remove(0));
+    CHECK(!analyzer.remove(0));
+    CHECK(analyzer.try_admit(c));
+    CHECK(analyzer.beta(1) == 3.0);
+    CHECK(analyzer.beta(2) == 1.5);
+
+    // Deadlines on the grid count at their own point: a second job of 3 due at 5 makes dbf(5) = 6,
+    // and a job of 10 due at 5 never fits
+    IncrementalAnalyzer on_point(BOUND_QPA);
+    CHECK(on_point.try_admit(test_task(3, 20, 5, 3)));
+    CHECK(!on_point.try_admit(test_task(4, 20, 5, 3)));
+    CHECK(on_point.remove(3));
+    CHECK(!on_point.try_admit(test_task(5, 20, 5, 10)));
+    CHECK(on_point.size() == 0);
+}
+
+// Admissions and removals in random order; after every step the analyzer's decision and the beta
+// of every admitted task are those of a full analyze_taskset() of the resulting task set
+
+static void check_against_full_analysis(TestingBound bound, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    IncrementalAnalyzer analyzer(bound);
+    AnalysisScratch scratch;
+    std::vector<Tasks> one;
+    int next_id = 0;
+    for (int step = 0; step < 400; step++) {
+        std::vector<Tasks> admitted = analyzer.tasks();
+        if (!admitted.empty() && unit(rng) < 0.35) {
+            int id = admitted[std::size_t(unit(rng) * admitted.size())].id;
+            CHECK(analyzer.remove(id));
+            CHECK(!analyzer.remove(id));
+        } else {
+            random_test_tasks(rng, 1, 0.02 + 0.28 * unit(rng), one);
+            one[0].id = next_id++;
+            std::vector<Tasks> candidate = admitted;
+            candidate.push_back(one[0]);
+            bool expected = analyze_taskset(candidate.data(), candidate.size(), bound, scratch);
+            CHECK(analyzer.try_admit(one[0]) == expected);
+        }
+
+        admitted = analyzer.tasks();
+        CHECK(admitted.size() == analyzer.size());
+        if (admitted.empty()) {
+            continue;
+        }
+        CHECK(analyze_taskset(admitted.data(), admitted.size(), bound, scratch));
+        for (std::size_t i = 0; i < admitted.size(); i++) {
+            CHECK(same_beta(analyzer.beta(admitted[i].id), scratch.beta_per_task[i]));
+        }
+    }
+}
+
+int main() {
+    check_known_answers();
+    uint64_t seed = 0x1ac4;
+    for (TestingBound bound : {BOUND_MAX_DEADLINE, BOUND_BUSY_PERIOD, BOUND_LA_LB, BOUND_QPA}) {
+        for (int run = 0; run < 5; run++) {
+            check_against_full_analysis(bound, seed++);
+        }
+    }
+    return test_result();
+}
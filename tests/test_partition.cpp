@@ -0,0 +1,77 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_partition.h"
+#include "test_support.h"
+
+// Hand-placed sets on two cores: first-fit decreasing puts the 0.6 tasks (1 and 3) on separate cores and fills
+// each up to 0.9 with a 0.3 task; three 0.7 tasks leave the last one unplaced under every heuristic
+
+static void check_known_answers() {
+    std::vector<Tasks> fits = {test_task(0, 10, 9.5, 3), test_task(1, 10, 9.5, 6), test_task(2, 10, 9.5, 3),
+                               test_task(3, 10, 9.5, 6)};
+    PartitionResult result;
+    CHECK(partition_with_heuristic(fits, 2, PartitionHeuristic(), BOUND_QPA, &result));
+    CHECK(result.feasible);
+    CHECK(result.core_of_task == std::vector<int>({0, 0, 1, 1}));
+    CHECK(result.core_utilization.size() == 2);
+    CHECK(std::fabs(result.core_utilization[0] - 0.9) < 1e-12 && std::fabs(result.core_utilization[1] - 0.9) < 1e-12);
+    CHECK(!partition_with_heuristic(fits, 1, PartitionHeuristic(), BOUND_QPA, &result));
+
+    std::vector<Tasks> over = {test_task(0, 10, 9.5, 7), test_task(1, 10, 9.5, 7), test_task(2, 10, 9.5, 7)};
+    PartitionOptions options;
+    options.bound = BOUND_QPA;
+    CHECK(!partition_tasks(over, 2, options, &result));
+    CHECK(!result.feasible);
+    CHECK(result.unplaced_task == 2);
+    CHECK(result.core_of_task == std::vector<int>({0, 1, -1}));
+    CHECK(result.heuristics_tried == int(partition_heuristics().size()));
+    CHECK(partition_tasks(over, 3, options, &result));
+}
+
+// A feasible partition passes the uniprocessor test on every core, and the parallel search returns
+// the first heuristic in list order that is feasible on its own
+
+static void check_random_partitions() {
+    std::mt19937_64 rng(0x9a27);
+    std::vector<Tasks> tasks;
+    std::vector<std::vector<Tasks>> cores;
+    std::vector<PartitionHeuristic> heuristics = partition_heuristics();
+    AnalysisScratch scratch;
+    long long feasible = 0;
+    for (int k = 0; k < 60; k++) {
+        int num_cores = 2 + k % 3;
+        random_test_tasks(rng, 4 * num_cores, 0.8 * num_cores, tasks);
+        PartitionOptions options;
+        options.threads = 1 + k % 4;
+        PartitionResult result;
+        bool ok = partition_tasks(tasks, num_cores, options, &result);
+        CHECK(ok == result.feasible);
+
+        int first = -1;
+        for (std::size_t h = 0; h < heuristics.size() && first < 0; h++) {
+            if (partition_with_heuristic(tasks, num_cores, heuristics[h], options.bound)) {
+                first = int(h);
+            }
+        }
+        CHECK(ok == (first >= 0));
+        if (!ok || first < 0) {
+            continue;
+        }
+        feasible++;
+        CHECK(result.heuristic.fit == heuristics[first].fit && result.heuristic.order == heuristics[first].order);
+        partition_cores(tasks, result, cores);
+        CHECK(int(cores.size()) == num_cores);
+        for (const std::vector<Tasks>& core : cores) {
+            CHECK(analyze_taskset(core.data(), core.size(), options.bound, scratch));
+        }
+    }
+    CHECK(feasible > 0);
+}
+
+int main() {
+    check_known_answers();
+    check_random_partitions();
+    return test_result();
+}
@@ -0,0 +1,88 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "multi_phase_sensitivity.h"
+#include "test_support.h"
+
+static bool near(double value, double expected) {
+    return std::fabs(value - expected) <= 1e-5 * expected;
+}
+
+// Hand-computed factors. The only point before max(D_i) = 6.5 is td = 3 with a slack of 2, so the
+// clean up of B (the task with a deadline after it) may grow to 2 + 1 = 3, six times its 0.5 and 1.5
+// times its phase WCET. Scaling every WCET by s puts 3s of demand at td = 7; A alone fills td = 3 at
+// s = 3, and B alone reaches 1 + 2s = 7 at s = 3.
+
+static void check_known_answers() {
+    std::vector<Tasks> tasks = {test_task(0, 10, 2.5, 1, 0.5), test_task(1, 20, 6.5, 2, 0.5)};
+    SensitivityAnalyzer analyzer(BOUND_QPA);
+    SensitivityOptions options;
+    SensitivityResult result;
+    analyzer.analyze(tasks, options, result);
+    CHECK(result.schedulable);
+    CHECK(result.taskset.cleanup_scaling == 6.0);
+    CHECK(result.taskset.cleanup_fraction == 1.5);
+    CHECK(near(result.taskset.wcet_scaling, 7.0 / 3.0));
+    CHECK(result.per_task.size() == 2);
+    if (result.per_task.size() != 2) {
+        return;
+    }
+    CHECK(std::isinf(result.per_task[0].cleanup_scaling) && std::isinf(result.per_task[0].cleanup_fraction));
+    CHECK(result.per_task[1].cleanup_scaling == 6.0);
+    CHECK(near(result.per_task[0].wcet_scaling, 3.0));
+    CHECK(near(result.per_task[1].wcet_scaling, 3.0));
+
+    // Deadlines on the points 5 and 10: the job due at 10 counts there, so 2s + 3s = 10 bounds the
+    // WCET factor at 2 (counting it only after 10 would allow 25 / 7)
+    std::vector<Tasks> on_point = {test_task(0, 20, 5, 2), test_task(1, 20, 10, 3)};
+    options.per_task = false;
+    analyzer.analyze(on_point, options, result);
+    CHECK(result.schedulable);
+    CHECK(near(result.taskset.wcet_scaling, 2.0));
+}
+
+static bool scaled_schedulable(const std::vector<Tasks>& tasks, double wcet_scaling, double cleanup_scaling,
+                               TestingBound bound, AnalysisScratch& scratch) {
+    std::vector<Tasks> scaled = tasks;
+    for (Tasks& task : scaled) {
+        task.wcet *= wcet_scaling;
+        task.cleanup *= cleanup_scaling;
+    }
+    return analyze_taskset(scaled.data(), scaled.size(), bound, scratch);
+}
+
+// On random sets the verdict matches analyze_taskset(), and the task set factors separate passing
+// from failing scalings
+
+static void check_against_analysis() {
+    std::mt19937_64 rng(0x5e45);
+    AnalysisScratch scratch;
+    std::vector<Tasks> tasks;
+    SensitivityOptions options;
+    options.per_task = false;
+    SensitivityResult result;
+    for (TestingBound bound : {BOUND_BUSY_PERIOD, BOUND_QPA}) {
+        SensitivityAnalyzer analyzer(bound);
+        for (int k = 0; k < 300; k++) {
+            random_test_tasks(rng, 2 + k % 7, 0.3 + 0.6 * (k % 10) / 10, tasks);
+            analyzer.analyze(tasks, options, result);
+            CHECK(result.schedulable == analyze_taskset(tasks.data(), tasks.size(), bound, scratch));
+            double wcet = result.taskset.wcet_scaling;
+            if (wcet > 0.0 && std::isfinite(wcet)) {
+                CHECK(scaled_schedulable(tasks, wcet * (1 - 1e-4), 1.0, bound, scratch));
+                CHECK(!scaled_schedulable(tasks, wcet * (1 + 1e-4), 1.0, bound, scratch));
+            }
+            double cleanup = result.taskset.cleanup_scaling;
+            if (cleanup > 0.0 && std::isfinite(cleanup)) {
+                CHECK(scaled_schedulable(tasks, 1.0, cleanup * (1 - 1e-4), bound, scratch));
+                CHECK(!scaled_schedulable(tasks, 1.0, cleanup * (1 + 1e-4), bound, scratch));
+            }
+        }
+    }
+}
+
+int main() {
+    check_known_answers();
+    check_against_analysis();
+    return test_result();
+}
@@ -0,0 +1,113 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_sim.h"
+#include "test_support.h"
+
+// Hand-traced runs of single-phase tasks
+
+static void check_known_answers() {
+    SimScratch scratch;
+    SimResult result;
+
+    // Every job runs 4 and cleans up for 1 without interference: responses of 5, releases at 0, 10, 20
+    std::vector<Tasks> alone = {test_task(0, 10, 10, 4, 1)};
+    alone[0].phases = 1;
+    simulate_taskset(alone.data(), alone.size(), nullptr, 30, scratch, result);
+    CHECK(result.jobs == 3);
+    CHECK(result.deadline_misses == 0);
+    CHECK(result.preemptions == 0);
+    CHECK(result.cleanup_time == 3.0);
+    CHECK(result.max_response_time == 5.0);
+    CHECK(result.end_time == 25.0);
+
+    // A (3 chunks of 2, clean up 0.5) starts after B's first job at 1. B's second release at 3
+    // preempts it at the chunk boundary: A cleans up until 3.5, B runs until 4.5, A finishes its
+    // two remaining chunks and clean up at 9.
+    std::vector<Tasks> pair = {test_task(0, 100, 100, 6, 0.5), test_task(1, 3, 3, 1)};
+    pair[0].phases = 1;
+    pair[1].phases = 1;
+    std::vector<int> chunks(2 * MAX_PHASES, 1);
+    chunks[0] = 3;
+    simulate_taskset(pair.data(), pair.size(), chunks.data(), 4, scratch, result);
+    CHECK(result.per_task[0].jobs == 1);
+    CHECK(result.per_task[0].preemptions == 1);
+    CHECK(result.per_task[0].cleanup_time == 1.0);
+    CHECK(result.per_task[0].max_response_time == 9.0);
+    CHECK(result.per_task[0].max_nonpreemptive == 2.5);
+    CHECK(result.per_task[1].jobs == 2);
+    CHECK(result.per_task[1].max_response_time == 1.5);
+    CHECK(result.deadline_misses == 0);
+    CHECK(result.end_time == 9.0);
+
+    // A response of 4 against a deadline of 3 misses every job
+    std::vector<Tasks> late = {test_task(0, 10, 3, 4)};
+    late[0].phases = 1;
+    simulate_taskset(late.data(), late.size(), nullptr, 20, scratch, result);
+    CHECK(result.jobs == 2);
+    CHECK(result.deadline_misses == 2);
+}
+
+// Uniform phases each run the full wcet (task_phase_wcet), as the analysis assumes: two phases of 3,
+// each followed by a clean up of 1, complete the job at 8
+
+static void check_uniform_phases() {
+    SimScratch scratch;
+    SimResult result;
+    std::vector<Tasks> phased = {test_task(0, 20, 20, 3, 1)};
+    phased[0].phases = 2;
+    simulate_taskset(phased.data(), phased.size(), nullptr, 20, scratch, result);
+    CHECK(result.jobs == 1);
+    CHECK(result.cleanup_time == 2.0);
+    CHECK(result.max_response_time == 8.0);
+    CHECK(result.per_task[0].max_nonpreemptive == 4.0);
+    CHECK(result.end_time == 8.0);
+}
+
+// Every job released before the horizon completes, and every completed phase is cleaned up
+
+static void check_job_accounting() {
+    std::mt19937_64 rng(0x51a);
+    SimScratch scratch;
+    SimResult result;
+    std::vector<Tasks> tasks;
+    for (int k = 0; k < 200; k++) {
+        random_test_tasks(rng, 6, 0.7, tasks);
+        simulate_taskset(tasks.data(), tasks.size(), nullptr, 5000, scratch, result);
+        for (std::size_t i = 0; i < tasks.size(); i++) {
+            const SimTaskStats& stats = result.per_task[i];
+            CHECK(stats.jobs == (long long)std::ceil(5000 / tasks[i].period));
+            double phase_cleanups = double(stats.jobs) * tasks[i].phases * tasks[i].cleanup;
+            CHECK(stats.cleanup_time >= phase_cleanups * (1 - 1e-9));
+        }
+    }
+}
+
+// The sweep's results depend on the task set index only, not on the number of threads
+
+static void check_sweep() {
+    GeneratorParams params;
+    params.num_tasks = 5;
+    params.num_phases = 2;
+    params.max_utilization = 0.3;
+    std::vector<SimTasksetResult> serial, parallel;
+    run_simulation_sweep(params, 40, 0x5eed, 1, DEFAULT_TESTING_BOUND, 2000, serial);
+    run_simulation_sweep(params, 40, 0x5eed, 4, DEFAULT_TESTING_BOUND, 2000, parallel);
+    CHECK(serial.size() == 40 && parallel.size() == 40);
+    for (std::size_t k = 0; k < serial.size() && k < parallel.size(); k++) {
+        CHECK(serial[k].schedulable == parallel[k].schedulable);
+        CHECK(serial[k].beta_per_task == parallel[k].beta_per_task);
+        CHECK(serial[k].sim.jobs == parallel[k].sim.jobs && serial[k].sim.jobs > 0);
+        CHECK(serial[k].sim.deadline_misses == parallel[k].sim.deadline_misses);
+        CHECK(serial[k].sim.cleanup_time == parallel[k].sim.cleanup_time);
+    }
+}
+
+int main() {
+    check_known_answers();
+    check_uniform_phases();
+    check_job_accounting();
+    check_sweep();
+    return test_result();
+}
@@ -0,0 +1,84 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+
+// Minimal support for the regression tests: CHECK stays active in Release builds (unlike assert),
+// reports every failed condition and makes test_result() fail the test.
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+#define CHECK(condition)                                                     \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            test_failure(__FILE__, __LINE__, #condition);                    \
+        }                                                                    \
+    } while (0)
+
+// Failures printed before the rest are only counted
+#define TEST_MAX_REPORTED 20
+
+// Period range and clean up share of the random task sets
+#define TEST_MIN_PERIOD 10.0
+#define TEST_MAX_PERIOD 1000.0
+#define TEST_CLEANUP_FRACTION 0.25
+
+// =====================
+// FUNCTION DEFINITIONS
+// =====================
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void test_failure(const char* file, int line, const char* condition) {
+    if (test_failures()++ < TEST_MAX_REPORTED) {
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, condition);
+    }
+}
+
+// Exit status of a test: 0 if every CHECK held
+inline int test_result() {
+    if (test_failures() > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", test_failures());
+        return 1;
+    }
+    return 0;
+}
+
+// Task of a hand-computed task set
+inline Tasks test_task(int id, double period, double deadline, double wcet, double cleanup = 0.0) {
+    Tasks task;
+    task.id = id;
+    task.period = period;
+    task.deadline = deadline;
+    task.wcet = wcet;
+    task.utilization = wcet / period;
+    task.cleanup = cleanup;
+    return task;
+}
+
+// Random task set with unrounded UUniFast utilizations summing to 'utilization', log-uniform periods
+// and constrained deadlines in [0.5, 1] * period. It does not go through the generator, so the tests
+// see the same task sets whatever the generator does.
+inline void random_test_tasks(std::mt19937_64& rng, int num_tasks, double utilization, std::vector<Tasks>& tasks) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    tasks.resize(num_tasks);
+    double remaining = utilization;
+    for (int i = 0; i < num_tasks; i++) {
+        double next = i + 1 < num_tasks ? remaining * std::pow(unit(rng), 1.0 / (num_tasks - i - 1)) : 0.0;
+        double period = TEST_MIN_PERIOD * std::pow(TEST_MAX_PERIOD / TEST_MIN_PERIOD, unit(rng));
+        double wcet = (remaining - next) * period;
+        tasks[i] = test_task(i, period, period * (0.5 + 0.5 * unit(rng)), wcet, TEST_CLEANUP_FRACTION * wcet);
+        remaining = next;
+    }
+}
+
+#endif
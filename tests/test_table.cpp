@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "multi-phase.h"
+#include "multi_phase_table.h"
+#include "test_support.h"
+
+#define TABLE_PATH "test_table.mptab"
+#define TABLE_TICKS_PER_UNIT 10
+
+// Task set with harmonic periods, so that hyperperiods stay short enough to look up every tick. Every
+// uniform phase runs the full wcet, so the wcets are drawn for utilization / NUM_PHASES.
+static void generate_harmonic_tasks(std::mt19937_64& rng, int num_tasks, double utilization, std::vector<Tasks>& tasks) {
+    const double periods[] = {10, 20, 40, 80};
+    random_test_tasks(rng, num_tasks, utilization / NUM_PHASES, tasks);
+    for (Tasks& task : tasks) {
+        double scale = periods[rng() % 4] / task.period;
+        task.period *= scale;
+        task.deadline *= scale;
+        task.wcet *= scale;
+        task.cleanup *= scale;
+    }
+}
+
+// Entry covering tick 'offset' of the hyperperiod by linear search, or nullptr in idle time
+static const TableEntry* covering_entry(const ScheduleTableReader& table, Ticks offset) {
+    for (std::size_t k = 0; k < table.size(); k++) {
+        if (table[k].start <= offset && offset < table[k].start + Ticks(table[k].length)) {
+            return &table[k];
+        }
+    }
+    return nullptr;
+}
+
+// Every tick of the hyperperiod (and of a later one) looks up the entry that covers it, the chunk of
+// the run the tick lies in, or the idle gap around it
+
+static void check_lookup(const ScheduleTableReader& table, const ScheduleTableStats& stats) {
+    const Ticks hyperperiod = table.hyperperiod();
+    Ticks busy = 0;
+    for (std::size_t k = 0; k < table.size(); k++) {
+        busy += table[k].length;
+        CHECK(k == 0 || table[k - 1].start + Ticks(table[k - 1].length) <= table[k].start);
+    }
+    CHECK(busy == stats.busy);
+
+    for (Ticks t = 0; t < hyperperiod; t++) {
+        TableSlot slot = table.lookup(t);
+        TableSlot later = table.lookup(t + 3 * hyperperiod);
+        CHECK(later.kind == slot.kind && later.task == slot.task && later.chunk == slot.chunk && later.start == slot.start);
+        CHECK(slot.start <= t && t < slot.end);
+
+        const TableEntry* entry = covering_entry(table, t);
+        if (entry == nullptr) {
+            CHECK(slot.kind == TABLE_IDLE && slot.task == -1);
+            continue;
+        }
+        CHECK(slot.kind == TableEntryKind(entry->kind) && slot.task == entry->task && slot.phase == entry->phase);
+        CHECK(entry->start <= slot.start && slot.end <= entry->start + Ticks(entry->length));
+        if (entry->kind == TABLE_CHUNK) {
+            const TableTask& task = table.task(entry->task);
+            Ticks length = task.phase_wcet[entry->phase];
+            Ticks chunks = task.chunks[entry->phase];
+            Ticks position = entry->first_chunk * length / chunks + (t - entry->start);
+            CHECK(slot.chunk >= int(entry->first_chunk) && slot.chunk < int(entry->first_chunk + entry->num_chunks));
+            CHECK(slot.chunk * length / chunks <= position && position < (slot.chunk + 1) * length / chunks);
+        }
+    }
+}
+
+// One task of 4 units with a clean up of 1 in a period of 10: a chunk in [0, 4), its clean up in
+// [4, 5) and idle time up to the next release; tick 23 lies in the chunk of the third hyperperiod
+
+static void check_known_answer() {
+    std::vector<Tasks> tasks = {test_task(7, 10, 10, 4, 1)};
+    tasks[0].phases = 1;
+    std::string error;
+    ScheduleTableStats stats;
+    CHECK(write_schedule_table(TABLE_PATH, tasks, 1, BOUND_QPA, &error, &stats));
+    ScheduleTableReader table;
+    CHECK(table.open(TABLE_PATH, &error));
+    CHECK(table.hyperperiod() == 10 && table.size() == 2 && stats.busy == 5);
+    if (table.size() != 2) {
+        return;
+    }
+    CHECK(table.task(0).id == 7 && table.task(0).chunks[0] == 1);
+    CHECK(table[0].start == 0 && table[0].length == 4 && table[0].kind == TABLE_CHUNK);
+    CHECK(table[1].start == 4 && table[1].length == 1 && table[1].kind == TABLE_CLEANUP);
+    TableSlot slot = table.lookup(23);
+    CHECK(slot.kind == TABLE_CHUNK && slot.task == 0 && slot.chunk == 0 && slot.start == 0 && slot.end == 4);
+    slot = table.lookup(4);
+    CHECK(slot.kind == TABLE_CLEANUP && slot.start == 4 && slot.end == 5);
+    slot = table.lookup(7);
+    CHECK(slot.kind == TABLE_IDLE && slot.start == 5 && slot.end == 10);
+}
+
+// Two uniform phases of the same task run the full wcet each, as in simulate_taskset(): chunk, clean
+// up, chunk, clean up over [0, 10)
+
+static void check_uniform_phases() {
+    std::vector<Tasks> tasks = {test_task(3, 20, 20, 4, 1)};
+    tasks[0].phases = 2;
+    std::string error;
+    ScheduleTableStats stats;
+    CHECK(write_schedule_table(TABLE_PATH, tasks, 1, BOUND_QPA, &error, &stats));
+    ScheduleTableReader table;
+    CHECK(table.open(TABLE_PATH, &error));
+    CHECK(table.size() == 4 && stats.busy == 10);
+    if (table.size() != 4) {
+        return;
+    }
+    CHECK(table.task(0).phase_wcet[0] == 4 && table.task(0).phase_wcet[1] == 4);
+    CHECK(table[2].start == 5 && table[2].length == 4 && table[2].kind == TABLE_CHUNK && table[2].phase == 1);
+    CHECK(table[3].start == 9 && table[3].length == 1 && table[3].kind == TABLE_CLEANUP);
+}
+
+int main() {
+    check_known_answer();
+    check_uniform_phases();
+    std::mt19937_64 rng(0x7ab1e);
+    std::uniform_real_distribution<double> utilization(0.3, 0.9);
+    std::vector<Tasks> tasks;
+    int tables = 0;
+    for (int k = 0; k < 60; k++) {
+        generate_harmonic_tasks(rng, 2 + k % 4, utilization(rng), tasks);
+        std::string error;
+        ScheduleTableStats stats;
+        if (!write_schedule_table(TABLE_PATH, tasks, TABLE_TICKS_PER_UNIT, DEFAULT_TESTING_BOUND, &error, &stats)) {
+            continue; // Not schedulable on the tick grid
+        }
+        ScheduleTableReader table;
+        CHECK(table.open(TABLE_PATH, &error));
+        CHECK(table.hyperperiod() == stats.hyperperiod && Ticks(table.size()) == stats.entries);
+        check_lookup(table, stats);
+        tables++;
+    }
+    CHECK(tables > 0);
+    std::remove(TABLE_PATH);
+    return test_result();
+}
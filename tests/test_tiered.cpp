@@ -0,0 +1,64 @@
+#include <random>
+#include <vector>
+#include "multi-phase.h"
+#include "test_support.h"
+
+static AnalysisScratch tiered;
+
+static bool decide(const std::vector<Tasks>& tasks, AnalysisTier tier) {
+    bool result = analyze_taskset_tiered(tasks.data(), tasks.size(), BOUND_QPA, tiered);
+    CHECK(tiered.result.tier == tier);
+    return result;
+}
+
+// Hand-computed sets each filter decides: U = 13/12, a first deadline point at 3 with demand 3.5,
+// and a density of 0.1 that leaves beta far above the clean up cost
+
+static void check_known_answers() {
+    std::vector<Tasks> overloaded = {test_task(0, 2, 2, 1.5), test_task(1, 3, 3, 1)};
+    CHECK(!decide(overloaded, TIER_UTILIZATION));
+    CHECK(tiered.result.verdict == ANALYSIS_OVERLOADED);
+
+    std::vector<Tasks> first_point = {test_task(0, 10, 2.5, 3.5), test_task(1, 20, 6.5, 1)};
+    CHECK(!decide(first_point, TIER_FIRST_POINT));
+    CHECK(tiered.result.verdict == ANALYSIS_DEMAND_EXCEEDED);
+    CHECK(tiered.result.failing_td == 3);
+
+    std::vector<Tasks> light = {test_task(0, 100, 100, 10, 0.5)};
+    CHECK(decide(light, TIER_DENSITY));
+}
+
+// The pre-filters of analyze_taskset_tiered() only decide task sets the exact analysis decides alike;
+// sets they pass on get the exact verdict itself
+
+static void check_against_exact() {
+    std::mt19937_64 rng(0x7e4d);
+    AnalysisScratch exact;
+    std::vector<Tasks> tasks;
+    long long filtered = 0;
+    for (TestingBound bound : {BOUND_MAX_DEADLINE, BOUND_BUSY_PERIOD, BOUND_LA_LB, BOUND_QPA}) {
+        for (int num_tasks : {1, 3, 4, 8, 16}) {
+            for (double utilization : {0.3, 0.6, 0.8, 0.95, 0.99}) {
+                for (int k = 0; k < 150; k++) {
+                    random_test_tasks(rng, num_tasks, utilization, tasks);
+                    bool expected = analyze_taskset(tasks.data(), tasks.size(), bound, exact);
+                    bool result = analyze_taskset_tiered(tasks.data(), tasks.size(), bound, tiered);
+                    CHECK(result == expected);
+                    if (tiered.result.tier == TIER_EXACT) {
+                        CHECK(tiered.result.verdict == exact.result.verdict);
+                        CHECK(tiered.result.failing_td == exact.result.failing_td);
+                    } else {
+                        filtered++;
+                    }
+                }
+            }
+        }
+    }
+    CHECK(filtered > 0);
+}
+
+int main() {
+    check_known_answers();
+    check_against_exact();
+    return test_result();
+}
@@ -0,0 +1,122 @@
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include "work_stealing.h"
+
+// Remaining index range [begin, end) owned by one worker
+
+typedef struct alignas(64) WorkRange {
+    std::mutex lock;
+    long long begin = 0;
+    long long end = 0;
+} WorkRange;
+
+int resolve_num_threads(int num_threads) {
+    if (num_threads > 0) {
+        return num_threads;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// Claims up to WORK_STEALING_GRAIN indices from the front of the worker's own range
+
+static bool claim_own(WorkRange& range, long long& first, long long& last) {
+    std::lock_guard<std::mutex> guard(range.lock);
+    if (range.begin >= range.end) {
+        return false;
+    }
+    first = range.begin;
+    last = std::min(range.end, range.begin + WORK_STEALING_GRAIN);
+    range.begin = last;
+    return true;
+}
+
+// Moves the upper half of the fullest victim range into the thief's (empty) range
+
+static bool steal(std::vector<WorkRange>& ranges, int thief) {
+    int num_workers = static_cast<int>(ranges.size());
+    while (true) {
+        int victim = -1;
+        long long largest = 0;
+        for (int w = 0; w < num_workers; w++) {
+            if (w == thief) {
+                continue;
+            }
+            std::lock_guard<std::mutex> guard(ranges[w].lock);
+            long long remaining = ranges[w].end - ranges[w].begin;
+            if (remaining > largest) {
+                largest = remaining;
+                victim = w;
+            }
+        }
+        if (victim < 0) {
+            return false;
+        }
+
+        long long first = 0;
+        long long last = 0;
+        {
+            std::lock_guard<std::mutex> guard(ranges[victim].lock);
+            long long remaining = ranges[victim].end - ranges[victim].begin;
+            if (remaining <= 0) {
+                continue; // Drained between the scan and the steal, look again
+            }
+            last = ranges[victim].end;
+            first = last - (remaining + 1) / 2;
+            ranges[victim].end = first;
+        }
+
+        std::lock_guard<std::mutex> guard(ranges[thief].lock);
+        ranges[thief].begin = first;
+        ranges[thief].end = last;
+        return true;
+    }
+}
+
+void parallel_for_each_index(long long count, int num_threads,
+                             const std::function<void(long long index, int worker)>& body) {
+
+    if (count <= 0) {
+        return;
+    }
+
+    int num_workers = static_cast<int>(std::min<long long>(resolve_num_threads(num_threads), count));
+    if (num_workers == 1) {
+        for (long long index = 0; index < count; index++) {
+            body(index, 0);
+        }
+        return;
+    }
+
+    std::vector<WorkRange> ranges(num_workers);
+    for (int w = 0; w < num_workers; w++) {
+        ranges[w].begin = count * w / num_workers;
+        ranges[w].end = count * (w + 1) / num_workers;
+    }
+
+    auto worker_loop = [&](int worker) {
+        long long first = 0;
+        long long last = 0;
+        while (true) {
+            if (!claim_own(ranges[worker], first, last)) {
+                if (!steal(ranges, worker)) {
+                    break;
+                }
+                continue;
+            }
+            for (long long index = first; index < last; index++) {
+                body(index, worker);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int w = 1; w < num_workers; w++) {
+        threads.emplace_back(worker_loop, w);
+    }
+    worker_loop(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <functional>
+
+// =================
+// MACRO DEFINITIONS
+// =================
+
+// Number of indices a worker claims from its own range at a time
+#define WORK_STEALING_GRAIN 64
+
+// =====================
+// FUNCTION DECLARATIONS
+// =====================
+
+// Number of workers to use when 0 is requested (one per hardware thread)
+int resolve_num_threads(int num_threads);
+
+// Calls body(index, worker) for every index in [0, count) on num_threads workers.
+// Each worker starts on its own contiguous slice of the index range and, once that is
+// exhausted, steals the upper half of the largest remaining slice of another worker.
+void parallel_for_each_index(long long count, int num_threads,
+                             const std::function<void(long long index, int worker)>& body);
+
+#endif